@@ -33,6 +33,7 @@
 static uint16 lcd_dmode;			// lcd mode
 static uint8 lcd_y;					// row (0-159)
 static uint8 lcd_x;					// column (0-159)
+uint8 lcd_epoch;					// incremented by lcd_set (tiles)
 
 extern uint16 i2c_fSCL;				// i2c timing constant
 
@@ -271,6 +272,24 @@ void lcd_set_x_y(uint8 x, uint8 y)
 } // end lcd_set_x_y
 
 
+//******************************************************************************
+//	set lcd window (RAM columns col0-col1, lines line0-line1)
+//
+//	RAMWR/RAMRD then start at col0, line0 and wrap inside the window.
+//
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1)
+{
+	WriteCmd(0x75);					// set line address
+		WriteData(line0);			// from line0 - line1
+		WriteData(line1);
+
+	WriteCmd(0x15);					// set column address
+		WriteData(col0);			// from col0 - col1
+		WriteData(col1);
+	return;
+} // end lcd_set_window
+
+
 //******************************************************************************
 //	lcd read word
 //
@@ -322,20 +341,15 @@ void lcd_clear()
 //
 void lcd_set(uint16 value)
 { 
-	int i; 
-
 	lcd_set_x_y(0, 0);			// upper right corner
 	WriteCmd(0x5c);				// start write
 
-	// whole screen - rows x columns
-//	for (i = 0; i < 160 * (divu3((160*2))); i++)
-	for (i = 160 * (divu3((160*2))); i > 0; --i)
-	{
-		WriteData_word(value);
-	} 
+	// whole screen - rows x columns (54 words x 160 lines, once)
+	lcd_write_repeat(value, HD_Y_MAX * 54);
 	lcd_dmode = 0;				// reset mode
 	lcd_y = HD_Y_MAX - 1;		// upper left hand corner
 	lcd_x = 0;
+	++lcd_epoch;				// tile layer must be redrawn
 	return;
 } // end  lcd_set
 
@@ -50,9 +50,28 @@ uint8 lcd_fill(int16 x, int16 y, uint16 width, uint16 height, uint8 flag);
 #define lcd_image1	lcd_bitImage
 #define lcd_image2	lcd_wordImage
 
+//	lcd tile layer (lcd_tile.c)
+#define TILE_COLS			27			// 6 pixel columns (-2 to 159)
+#define TILE_ROWS			20			// 8 pixel rows
+#define TILE_WORDS			16			// 2 words x 8 lines per tile
+
+#define W2B3P(P0,P1,P2)	(0xffdf^(0xf800*(P0)|0x07c0*(P1)|0x001f*(P2)))
+
+void lcd_tile_init(uint8* map, uint8 col, uint8 row, uint8 cols, uint8 rows,
+	const uint16* tiles);
+void lcd_tile_set(uint8 col, uint8 row, uint8 tile);
+uint8 lcd_tile_get(uint8 col, uint8 row);
+void lcd_tile_invalidate(void);
+uint16 lcd_tile_flush(void);
+
 uint16 lcd_read_word(int16 x, int16 y);
 void lcd_write_word(int16 x, int16 y, uint16 data);
 
+//	lcd bus bursts (RBX430_lcd_bus.asm - after RAMWR)
+void lcd_write_burst(const uint16* src, uint16 count);
+void lcd_write_burst_inv(const uint16* src, uint16 count);
+void lcd_write_repeat(uint16 value, uint16 count);
+
 uint8 lcd_point(int16 x, int16 y, int16 flag);
 void lcd_circle(int16 x, int16 y, uint16 radius, uint8 pen);
 void lcd_square(int16 x, int16 y, uint16 side, uint8 pen);
@@ -0,0 +1,183 @@
+//	lcd_tile.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Tile map layer for YM160160C/ST7529 LCD
+//
+//	The screen is a grid of 6x8 pixel tiles (2 LCD words x 8 lines), so
+//	tiles line up with the 3 pixel 2B3P words and never need a read-modify
+//	-write.  TILE_COLS x TILE_ROWS tiles cover the whole LCD RAM; tile
+//	column c covers pixels 6c-2 to 6c+3 (column 0 is 2 pixels off screen)
+//	and tile row r covers lines 8r to 8r+7 (row 0 at the bottom).
+//
+//	A layer is a rectangle of the grid with a tile map (one tile index per
+//	byte) supplied by the application.  lcd_tile_set only updates the map
+//	and a dirty bit; lcd_tile_flush writes each run of dirty tiles in a row
+//	with one window and one RAMWR burst straight from the flash tile set.
+//
+//	Tile set: TILE_WORDS LCD RAM words per tile, top line first, each line
+//	= right word, left word (the order the controller auto-increments).
+//	W2B3P builds a word from 3 pixels (left to right, 1 = on);
+//	tools/lcd_tiles.py builds font tile sets (simon_tiles.c).
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+extern uint8 lcd_epoch;					// lcd_set count
+
+void WriteCmd(uint8 c);
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1);
+
+static uint8* tile_map;					// layer map (cols x rows, row 0 first)
+static const uint16* tile_set;			// tile bitmaps (flash)
+static uint8 tile_col, tile_row;		// layer lower left tile
+static uint8 tile_cols, tile_rows;		// layer size
+static uint8 tile_epoch;				// lcd_epoch at last flush
+static uint32 tile_dirty[TILE_ROWS];	// dirty bit per layer tile
+
+
+//******************************************************************************
+//	Tile functions:
+//
+//	void lcd_tile_init(uint8* map, uint8 col, uint8 row, uint8 cols,
+//		uint8 rows, const uint16* tiles)
+//	void lcd_tile_set(uint8 col, uint8 row, uint8 tile)
+//	uint8 lcd_tile_get(uint8 col, uint8 row)
+//	void lcd_tile_invalidate(void)
+//	uint16 lcd_tile_flush(void)
+//
+//******************************************************************************
+//	define tile layer
+//
+//	IN:		map			cols x rows tile indices, bottom row first
+//			col, row	lower left grid tile of layer
+//			cols, rows	layer size (clipped to grid)
+//			tiles		tile set (TILE_WORDS per tile)
+//
+void lcd_tile_init(uint8* map, uint8 col, uint8 row, uint8 cols, uint8 rows,
+	const uint16* tiles)
+{
+	if (col >= TILE_COLS) col = TILE_COLS - 1;
+	if (row >= TILE_ROWS) row = TILE_ROWS - 1;
+	if (cols > TILE_COLS - col) cols = TILE_COLS - col;
+	if (rows > TILE_ROWS - row) rows = TILE_ROWS - row;
+
+	tile_map = map;
+	tile_set = tiles;
+	tile_col = col;
+	tile_row = row;
+	tile_cols = cols;
+	tile_rows = rows;
+	lcd_tile_invalidate();				// draw whole layer on next flush
+	return;
+} // end lcd_tile_init
+
+
+//******************************************************************************
+//	set layer tile (col, row) - drawn by lcd_tile_flush
+//
+void lcd_tile_set(uint8 col, uint8 row, uint8 tile)
+{
+	uint8* map_ptr;
+	uint32 mask = 1;
+
+	if ((col >= tile_cols) || (row >= tile_rows)) return;
+	map_ptr = tile_map + row * tile_cols + col;
+	if (*map_ptr == tile) return;		// no change
+	*map_ptr = tile;
+	while (col--) mask <<= 1;
+	tile_dirty[row] |= mask;
+	return;
+} // end lcd_tile_set
+
+
+uint8 lcd_tile_get(uint8 col, uint8 row)
+{
+	if ((col >= tile_cols) || (row >= tile_rows)) return 0;
+	return tile_map[row * tile_cols + col];
+} // end lcd_tile_get
+
+
+//******************************************************************************
+//	mark every layer tile dirty
+//
+void lcd_tile_invalidate(void)
+{
+	uint32 all = 0;
+	uint8 i;
+
+	for (i = tile_cols; i > 0; --i) all = (all << 1) | 1;
+	for (i = 0; i < TILE_ROWS; ++i) tile_dirty[i] = (i < tile_rows) ? all : 0;
+	tile_epoch = lcd_epoch;
+	return;
+} // end lcd_tile_invalidate
+
+
+//******************************************************************************
+//	write run of dirty tiles first..last (layer columns) in row
+//
+static void lcd_tile_run(uint8 row, uint8 first, uint8 last)
+{
+	const uint8* map_ptr;
+	const uint16* line_ptr;
+	uint8 line, i;
+	uint8 words = (TILE_COLS - 1 - tile_col - last) << 1;	// right word
+	uint8 y = (tile_row + row) << 3;
+
+	lcd_set_window(words, words + ((last - first) << 1) + 1, y, y + 7);
+	WriteCmd(0x5c);						// RAMWR - write to memory
+
+	// lines bottom up, tiles right to left (controller order)
+	for (line = TILE_WORDS; line; )
+	{
+		line -= 2;						// tile data is top line first
+		map_ptr = tile_map + row * tile_cols + last;
+		for (i = last - first + 1; i > 0; --i)
+		{
+			line_ptr = tile_set + *map_ptr-- * TILE_WORDS + line;
+			lcd_write_burst(line_ptr, 2);	// right word, left word
+		}
+	}
+	return;
+} // end lcd_tile_run
+
+
+//******************************************************************************
+//	write dirty tiles to LCD
+//
+//	OUT:	number of tiles written
+//
+uint16 lcd_tile_flush(void)
+{
+	uint16 count = 0;
+	uint32 dirty, mask;
+	uint8 row, col, first;
+
+	if (tile_epoch != lcd_epoch) lcd_tile_invalidate();	// screen cleared
+
+	for (row = 0; row < tile_rows; ++row)
+	{
+		if ((dirty = tile_dirty[row]) == 0) continue;	// clean row
+		tile_dirty[row] = 0;
+
+		for (col = 0, mask = 1; col < tile_cols; )
+		{
+			if (!(dirty & mask))
+			{
+				++col;
+				mask <<= 1;
+				continue;
+			}
+			first = col;				// find end of dirty run
+			do
+			{
+				++col;
+				mask <<= 1;
+			} while ((col < tile_cols) && (dirty & mask));
+			lcd_tile_run(row, first, col - 1);
+			count += col - first;
+		}
+	}
+	return count;
+} // end lcd_tile_flush
@@ -60,6 +60,7 @@
 #include "RBX430_lcd.h"
 #include <time.h>
 #include <stdio.h>
+#include <string.h>
 //------------------------------------------------------------------------------
 // NOTE: LOOK in RBX430.h for some macros to use
 //------------------------------------------------------------------------------
@@ -69,6 +70,10 @@
 #define WDT_CPI 32000 // WDT Clocks Per Interrupt (@1 Mhz)
 #define WDT_IPS myCLOCK/WDT_CPI // WDT counts/second (32 ms)
 
+#define SIMON_TILE_CHARS " -0123456789CDEHILNORSU" // simon_tiles.c order
+#define SCORE_COLS 9 // scoreboard tiles (6x8 pixels)
+#define SCORE_ROWS 4
+
 #define TONE 2000 // beep frequency
 #define DELAY 100 // beep duration--------------------changed to 50
 
@@ -82,12 +87,19 @@ void delay (void); // Start delay of program
 void LEDs (int number); // Set the leds based on the number passed in
 void lcd_backlight(uint8 backlight);
 void victory_tone(void);
+void score_init(void); // draw scoreboard
+void score_show(int round, int score); // update round and score
+void score_game_over(int score); // update high and low scores
+extern const uint16 simon_tiles[]; // scoreboard font tiles
 //void lcd_printf(char* fmt, ...);
 //-----------------------------------------------------------
 // global variables
 volatile int WDTSecCnt; // WDT second counter
 volatile int WDT_Delay; // WDT delay counter
 volatile int fivesec = 6;
+uint8 score_map[SCORE_COLS * SCORE_ROWS]; // scoreboard tile map
+int hi_score = 0; // highest score
+int lo_score = -1; // lowest score (-1 = no game yet)
 
 //------------------------------------------------------------------------------
 //gameplay delay
@@ -121,6 +133,7 @@ void small_delay()
 
 		__bis_SR_register(GIE); // enable interrupts
 
+		score_init(); // round, score, high and low score
 
 		while(1){ //Run infinitely
 			int i = 0;
@@ -154,6 +167,8 @@ void small_delay()
 				int new_LED = LED_pin[new];  // that number then corresponds with a tone and LED from the above arrays
 				int new_tone = tone_freq[new];
 
+				score_show(round_num + 1, round_num);
+
 				LED_array[round_num] = new_LED;
 				sound_array[round_num] = new_tone;
 
@@ -200,6 +215,7 @@ void small_delay()
 						toneON(raspberry);
 						delay();
 						toneOFF();
+						score_game_over(round_num);
 						go = 0;
 						break;
 					}
@@ -298,3 +314,65 @@ delay(); // Delay
 toneOFF(); // Turn off tone
 return;
 }
+
+//------------------------------------------------------------------------------
+// Scoreboard (lcd_tile.c layer - only changed characters are redrawn)
+//
+//	ROUND  01
+//	SCORE  00
+//	HI     00
+//	LO     --
+//
+static void score_text(int row, int col, const char* text)
+{
+while (*text)
+{
+	lcd_tile_set(col++, row, strchr(SIMON_TILE_CHARS, *text++) - SIMON_TILE_CHARS);
+}
+return;
+}
+
+static void score_number(int row, int value)
+{
+char digits[3] = "--";
+if (value >= 0)
+{
+	digits[0] = '0' + value / 10 % 10;
+	digits[1] = '0' + value % 10;
+}
+score_text(row, SCORE_COLS - 2, digits);
+return;
+}
+
+void score_init()
+{
+memset(score_map, 0, sizeof(score_map)); // all ' '
+lcd_clear();
+lcd_tile_init(score_map, 9, 8, SCORE_COLS, SCORE_ROWS, simon_tiles);
+score_text(3, 0, "ROUND");
+score_text(2, 0, "SCORE");
+score_text(1, 0, "HI");
+score_text(0, 0, "LO");
+score_number(1, hi_score);
+score_number(0, lo_score);
+score_show(0, 0);
+return;
+}
+
+void score_show(int round, int score)
+{
+score_number(3, round);
+score_number(2, score);
+lcd_tile_flush(); // write changed tiles
+return;
+}
+
+void score_game_over(int score)
+{
+if (score > hi_score) hi_score = score;
+if ((lo_score < 0) || (score < lo_score)) lo_score = score;
+score_number(1, hi_score);
+score_number(0, lo_score);
+score_show(score + 1, score);
+return;
+}
@@ -0,0 +1,84 @@
+//	simon_tiles.c
+//******************************************************************************
+//	Description:	Scoreboard tiles for Simon (lcd_tile.c 6x8 font tiles)
+//
+//	Generated from the RBX430_lcd.c font with tools/lcd_tiles.py - tile n
+//	is character n of SIMON_TILE_CHARS (simon.c).
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+//	tile set for lcd_tile_init - tools/lcd_tiles.py " -0123456789CDEHILNORSU"
+const uint16 simon_tiles[] = {
+  // 0 ' '
+  0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,
+  0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,
+  // 1 '-'
+  0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0x0000,0xf800,
+  0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,0xffdf,
+  // 2 '0'
+  0x001f,0xffc0,0xffc0,0xf81f,0xf800,0xf81f,0x07c0,0xf81f,
+  0xffc0,0xf800,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+  // 3 '1'
+  0x07df,0xffdf,0x07df,0xffc0,0x07df,0xffdf,0x07df,0xffdf,
+  0x07df,0xffdf,0x07df,0xffdf,0x001f,0xffc0,0xffdf,0xffdf,
+  // 4 '2'
+  0x001f,0xffc0,0xffc0,0xf81f,0xffc0,0xffdf,0x001f,0xffdf,
+  0xffdf,0xffc0,0xffdf,0xf81f,0x0000,0xf800,0xffdf,0xffdf,
+  // 5 '3'
+  0x001f,0xffc0,0xffc0,0xf81f,0xffc0,0xffdf,0x001f,0xffc0,
+  0xffc0,0xffdf,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+  // 6 '4'
+  0xf81f,0xffdf,0x001f,0xffdf,0xf81f,0xffc0,0xf81f,0xf81f,
+  0x0000,0xf800,0xf81f,0xffdf,0xf81f,0xffdf,0xffdf,0xffdf,
+  // 7 '5'
+  0x0000,0xf800,0xffdf,0xf81f,0xffdf,0xf81f,0x001f,0xf800,
+  0xffc0,0xffdf,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+  // 8 '6'
+  0x0000,0xffdf,0xffdf,0xffc0,0xffdf,0xf81f,0x001f,0xf800,
+  0xffc0,0xf81f,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+  // 9 '7'
+  0x0000,0xf800,0xffc0,0xffdf,0xf81f,0xffdf,0x07df,0xffdf,
+  0xffdf,0xffc0,0xffdf,0xffc0,0xffdf,0xffc0,0xffdf,0xffdf,
+  // 10 '8'
+  0x001f,0xffc0,0xffc0,0xf81f,0xffc0,0xf81f,0x001f,0xffc0,
+  0xffc0,0xf81f,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+  // 11 '9'
+  0x001f,0xffc0,0xffc0,0xf81f,0xffc0,0xf81f,0x0000,0xffc0,
+  0xffc0,0xffdf,0xf81f,0xffdf,0x07df,0xffc0,0xffdf,0xffdf,
+  // 12 'C'
+  0x001f,0xffc0,0xffc0,0xf81f,0xffdf,0xf81f,0xffdf,0xf81f,
+  0xffdf,0xf81f,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+  // 13 'D'
+  0x001f,0xf800,0xffc0,0xf81f,0xffc0,0xf81f,0xffc0,0xf81f,
+  0xffc0,0xf81f,0xffc0,0xf81f,0x001f,0xf800,0xffdf,0xffdf,
+  // 14 'E'
+  0x0000,0xf800,0xffdf,0xf81f,0xffdf,0xf81f,0x001f,0xf800,
+  0xffdf,0xf81f,0xffdf,0xf81f,0x0000,0xf800,0xffdf,0xffdf,
+  // 15 'H'
+  0xffc0,0xf81f,0xffc0,0xf81f,0xffc0,0xf81f,0x0000,0xf800,
+  0xffc0,0xf81f,0xffc0,0xf81f,0xffc0,0xf81f,0xffdf,0xffdf,
+  // 16 'I'
+  0x07df,0xf800,0xffdf,0xffc0,0xffdf,0xffc0,0xffdf,0xffc0,
+  0xffdf,0xffc0,0xffdf,0xffc0,0x07df,0xf800,0xffdf,0xffdf,
+  // 17 'L'
+  0xffdf,0xf81f,0xffdf,0xf81f,0xffdf,0xf81f,0xffdf,0xf81f,
+  0xffdf,0xf81f,0xffdf,0xf81f,0x0000,0xf800,0xffdf,0xffdf,
+  // 18 'N'
+  0xffc0,0xf81f,0xffc0,0xf800,0x07c0,0xf81f,0xf800,0xf81f,
+  0xffc0,0xf81f,0xffc0,0xf81f,0xffc0,0xf81f,0xffdf,0xffdf,
+  // 19 'O'
+  0x001f,0xffc0,0xffc0,0xf81f,0xffc0,0xf81f,0xffc0,0xf81f,
+  0xffc0,0xf81f,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+  // 20 'R'
+  0x001f,0xf800,0xffc0,0xf81f,0xffc0,0xf81f,0x001f,0xf800,
+  0xf81f,0xf81f,0xffc0,0xf81f,0xffc0,0xf81f,0xffdf,0xffdf,
+  // 21 'S'
+  0x001f,0xffc0,0xffc0,0xf81f,0xffdf,0xf81f,0x001f,0xffc0,
+  0xffc0,0xffdf,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+  // 22 'U'
+  0xffc0,0xf81f,0xffc0,0xf81f,0xffc0,0xf81f,0xffc0,0xf81f,
+  0xffc0,0xf81f,0xffc0,0xf81f,0x001f,0xffc0,0xffdf,0xffdf,
+};
@@ -45,6 +45,7 @@
 #include "RBX430-1.h"
 
 uint16 i2c_fSCL;				// i2c timing constant
+uint16 mclk_kHz;				// MCLK = SMCLK (kHz)
 
 //******************************************************************************
 //	Initialization sequence for eZ430X MSP430F2274
@@ -62,24 +63,28 @@ uint8 RBX430_init(enum _430clock clock)
 			BCSCTL1 = CALBC1_1MHZ;			// Set range 1MHz
 			DCOCTL = CALDCO_1MHZ;			// Set DCO step + modulation
 			i2c_fSCL = (1200/I2C_FSCL);		// fSCL
+			mclk_kHz = 1000;			// MCLK (kHz)
 			break;
 
 		case _8MHZ:
 			BCSCTL1 = CALBC1_8MHZ;			// Set range 8MHz
 			DCOCTL = CALDCO_8MHZ;			// Set DCO step + modulation
 			i2c_fSCL = (8000/I2C_FSCL);		// fSCL
+			mclk_kHz = 8000;			// MCLK (kHz)
 			break;
 
 		case _12MHZ:
 			BCSCTL1 = CALBC1_12MHZ;			// Set range 12MHz
 			DCOCTL = CALDCO_12MHZ;			// Set DCO step + modulation
 			i2c_fSCL = (12000/I2C_FSCL);	// fSCL
+			mclk_kHz = 12000;			// MCLK (kHz)
 			break;
 
 		case _16MHZ:
 			BCSCTL1 = CALBC1_16MHZ;			// Set range 16MHz
 			DCOCTL = CALDCO_16MHZ;			// Set DCO step + modulation
 			i2c_fSCL = (16000/I2C_FSCL);	// fSCL
+			mclk_kHz = 16000;			// MCLK (kHz)
 			break;
 
 		default:
@@ -257,14 +262,3 @@ __interrupt void ADC10_ISR(void)
   return;
 }
 
-
-//******************************************************************************
-//	USCI interrupt service routine
-//
-#pragma vector = USCIAB0RX_VECTOR
-__interrupt void USCIAB0RX_ISR(void)
-{
-	// should not come here!!!!!!!
-	ERROR2(SYS_ERR_USCB_RX);
-	return;
-}
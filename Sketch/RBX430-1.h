@@ -49,7 +49,8 @@ enum SYS_ERRORS {	SYS_ERR_430init=1,		// 1 eZ430X initialize
 					SYS_ERR_I2C_ACK,		// 9 i2c ACK timeout
 					SYS_ERR_ADC_TO,			// 10 adc timeout
 					SYS_ERR_XL345_TO,		// 11 accelerometer timeout
-					SYS_ERR_XL345ID
+					SYS_ERR_XL345ID,		// 12 accelerometer ID
+					SYS_ERR_UART_TO			// 13 uart receive timeout
 				};
 
 //******************************************************************************
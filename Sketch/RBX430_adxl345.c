@@ -0,0 +1,312 @@
+//	RBX430_adxl345.c - ADXL345 accelerometer driver
+//******************************************************************************
+//******************************************************************************
+//	Description:	ADXL345 in FIFO stream mode on the RBX430-1 I2C bus
+//
+//	The ADXL345 samples at a fixed rate into its 32 sample FIFO and raises
+//	INT1 (P1.4) when XL_WATERMARK samples are waiting.  The P1.4 interrupt
+//	starts a drain that runs entirely from I2C completion callbacks (ISR
+//	context, CPU free or asleep):
+//
+//		read FIFO_STATUS						(entries waiting)
+//		read DATAX0-DATAZ1 once per entry		(6 byte burst pops 1 entry)
+//		INT1 still high? - drain again
+//
+//	A multi-byte read past DATAZ1 continues with the FIFO registers rather
+//	than the next FIFO entry, so each entry is its own 6 byte transaction
+//	(register write + repeated start read).  Compared with polling one
+//	sample at a time there are no empty status polls and one interrupt per
+//	XL_WATERMARK samples.  A batch costs one FIFO_STATUS read plus one read
+//	per entry - (XL_WATERMARK + 1) / XL_WATERMARK transactions per sample
+//	(1.25 at 4), a little more when INT1 is still high after a batch.
+//
+//	Samples go to a XL_RING_SIZE ring for xl_read.  When the ring is full
+//	the drain stops with entries left (xl_left) and they wait in the
+//	ADXL345 FIFO - xl_read restarts the drain once it has made room,
+//	counting the FIFO again first (FIFO_STATUS).  The FIFO is the deep
+//	buffer: a main loop that stops reading loses nothing for
+//	XL_RING_SIZE + 32 - XL_WATERMARK samples (up to XL_WATERMARK - 1 may
+//	be waiting below the watermark when it stops) - ~350ms at 100Hz.
+//	After that the FIFO overwrites its oldest samples; the restart then
+//	finds it full (xl_lost).
+//
+//	Full resolution mode
+//	gives ~3.9mg per LSB at every range, so samples are g in 8.8 fixed point
+//	(XL_1G = 256) with no arithmetic.  Range is +-4g.
+//
+//	The application owns the PORT1 vector (switches) and must call
+//	xl_port1_isr when P1IFG & ADXL345_INT.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+#include "RBX430_adxl345.h"
+
+#define XL_RING_MASK	(XL_RING_SIZE - 1)
+
+#define XL_DEVID		0x00			// registers
+#define XL_BW_RATE		0x2c
+#define XL_POWER_CTL	0x2d
+#define XL_INT_ENABLE	0x2e
+#define XL_INT_MAP		0x2f
+#define XL_DATA_FORMAT	0x31
+#define XL_DATAX0		0x32
+#define XL_FIFO_CTL		0x38
+#define XL_FIFO_STATUS	0x39
+
+#define XL_ID			0xe5			// DEVID value
+#define XL_MEASURE		0x08			// POWER_CTL
+#define XL_INT_WATERMARK	0x02		// INT_ENABLE/INT_MAP
+#define XL_FULL_RES		0x08			// DATA_FORMAT
+#define XL_RANGE_4G		0x01
+#define XL_STREAM		0x80			// FIFO_CTL
+#define XL_FIFO_SIZE	32				// FIFO entries
+
+#define XL_IDLE			0				// drain states
+#define XL_STATUS		1
+#define XL_DATA			2
+
+static XL_SAMPLE xl_ring[XL_RING_SIZE];	// samples
+static volatile uint8 xl_head;			// next free (ISR)
+static volatile uint8 xl_tail;			// next to read (xl_read)
+volatile uint16 xl_lost;				// FIFO found full (samples overwritten)
+volatile uint16 xl_reads;				// i2c transactions
+
+static I2C_XFER xl_xfer;				// drain transaction
+static uint8 xl_reg;					// 	register address
+static uint8 xl_buf[6];					// 	data read
+static volatile uint8 xl_state;			// 	XL_IDLE, XL_STATUS or XL_DATA
+static volatile uint8 xl_left;			// 	FIFO entries to read
+static volatile uint8 xl_kick;			// 	FIFO_STATUS read wanted
+
+static const uint8 xl_setup[][2] = {	// register, value
+	{ XL_POWER_CTL, 0 },				// standby
+	{ XL_DATA_FORMAT, XL_FULL_RES + XL_RANGE_4G },
+	{ XL_BW_RATE, 0 },					// (rate)
+	{ XL_FIFO_CTL, 0 },					// bypass - empties FIFO
+	{ XL_FIFO_CTL, XL_STREAM + XL_WATERMARK },
+	{ XL_INT_MAP, 0 },					// all on INT1
+	{ XL_INT_ENABLE, XL_INT_WATERMARK },
+	{ XL_POWER_CTL, XL_MEASURE }
+};
+
+
+//******************************************************************************
+//	queue drain transaction (ISR context)
+//
+//	IN:		state	XL_STATUS (read FIFO_STATUS) or XL_DATA (pop entry)
+//
+static void xl_submit(uint8 state)
+{
+	xl_reg = (state == XL_STATUS) ? XL_FIFO_STATUS : XL_DATAX0;
+	xl_xfer.rcount = (state == XL_STATUS) ? 1 : 6;
+	if (i2c_submit(&xl_xfer))
+	{
+		xl_state = XL_IDLE;				// queue full - xl_read retries
+		if (state == XL_STATUS) xl_kick = 1;
+		return;
+	}
+	xl_state = state;
+	++xl_reads;
+	return;
+} // end xl_submit
+
+
+//******************************************************************************
+//	next drain step (ISR context or interrupts disabled)
+//
+//	Pops the next FIFO entry only when the ring has room for it - else
+//	the drain goes idle and the entries wait in the FIFO for xl_read.
+//
+static void xl_drain(void)
+{
+	if (((xl_head + 1) & XL_RING_MASK) == xl_tail)
+	{
+		xl_state = XL_IDLE;				// ring full - xl_read restarts
+	}
+	else if (xl_left) xl_submit(XL_DATA);
+	else if (xl_kick || (P1IN & ADXL345_INT))	// (filled meanwhile)
+	{
+		xl_kick = 0;
+		xl_submit(XL_STATUS);
+	}
+	else xl_state = XL_IDLE;
+	return;
+} // end xl_drain
+
+
+//******************************************************************************
+//	drain transaction done (I2C ISR)
+//
+static void xl_done(I2C_XFER* xfer)
+{
+	XL_SAMPLE* sample;
+
+	if (xfer->status != I2C_OK)			// bus error - xl_read retries
+	{
+		xl_state = XL_IDLE;
+		xl_left = 0;					// (entry may have been popped)
+		xl_kick = 1;
+		return;
+	}
+	if (xl_state == XL_STATUS)
+	{
+		xl_left = xl_buf[0] & 0x3f;		// entries waiting
+		if (xl_left >= XL_FIFO_SIZE) ++xl_lost;	// (oldest overwritten)
+	}
+	else								// sample (little endian)
+	{
+		sample = &xl_ring[xl_head];		// (room checked by xl_drain)
+		sample->x = (xl_buf[1] << 8) | xl_buf[0];
+		sample->y = (xl_buf[3] << 8) | xl_buf[2];
+		sample->z = (xl_buf[5] << 8) | xl_buf[4];
+		xl_head = (xl_head + 1) & XL_RING_MASK;	// now visible to xl_read
+		--xl_left;
+	}
+	xl_drain();
+	return;
+} // end xl_done
+
+
+//******************************************************************************
+//	write ADXL345 register (waits)
+//
+static uint8 xl_write(uint8 reg, uint8 value)
+{
+	uint8 data[2];
+
+	data[0] = reg;
+	data[1] = value;
+	return i2c_write_read(XL_ADDR, data, 2, 0, 0);
+} // end xl_write
+
+
+//******************************************************************************
+//	ADXL345 functions:
+//
+//	uint8 xl_init(uint8 rate)
+//	uint8 xl_read(XL_SAMPLE* sample)
+//	uint8 xl_count(void)
+//	void xl_stop(void)
+//	void xl_port1_isr(void)
+//
+//******************************************************************************
+//	initialize ADXL345 - FIFO stream mode, watermark interrupt on P1.4
+//
+//	Call after i2c_init with interrupts enabled.
+//
+//	IN:		rate	XL_RATE_... output data rate
+//
+//	OUT:	return 0 (SYS_ERR_XL345 no response, SYS_ERR_XL345_TO bus
+//			timeout, SYS_ERR_XL345ID wrong device)
+//
+uint8 xl_init(uint8 rate)
+{
+	uint8 reg = XL_DEVID;
+	uint8 id = 0;
+	uint8 error, i;
+
+	P1IE &= ~ADXL345_INT;
+	error = i2c_write_read(XL_ADDR, &reg, 1, &id, 1);
+	if ((error == I2C_OK) && (id != XL_ID)) return SYS_ERR_XL345ID;
+	for (i = 0; !error && (i < sizeof(xl_setup) / 2); ++i)
+	{
+		reg = xl_setup[i][0];
+		error = xl_write(reg, (reg == XL_BW_RATE) ? rate : xl_setup[i][1]);
+	}
+	if (error == SYS_ERR_I2C_TO) return SYS_ERR_XL345_TO;
+	if (error) return SYS_ERR_XL345;
+
+	xl_xfer.addr = XL_ADDR;
+	xl_xfer.ms = 0;
+	xl_xfer.wdata = &xl_reg;
+	xl_xfer.wcount = 1;
+	xl_xfer.rdata = xl_buf;
+	xl_xfer.done = xl_done;
+	xl_head = xl_tail = 0;
+	xl_state = XL_IDLE;
+	xl_left = 0;
+	xl_kick = 0;
+	xl_lost = xl_reads = 0;
+
+	P1SEL &= ~ADXL345_INT;				// P1.4 input, rising edge
+	P1DIR &= ~ADXL345_INT;
+	P1IES &= ~ADXL345_INT;
+	P1IFG &= ~ADXL345_INT;
+	P1IE |= ADXL345_INT;
+	return 0;
+} // end xl_init
+
+
+//******************************************************************************
+//	get next sample
+//
+//	Restarts a drain that stopped on a full ring (entries left in the
+//	FIFO) or could not be queued.
+//
+//	OUT:	return 1 if sample returned (0 = none waiting)
+//
+uint8 xl_read(XL_SAMPLE* sample)
+{
+	uint8 tail = xl_tail;
+	uint8 got = 0;
+	uint16 gie;
+
+	if (tail != xl_head)
+	{
+		*sample = xl_ring[tail];
+		xl_tail = (tail + 1) & XL_RING_MASK;	// free sample for ISR
+		got = 1;
+	}
+	if ((xl_state == XL_IDLE) && (P1IE & ADXL345_INT)
+		&& (xl_left || xl_kick || (P1IN & ADXL345_INT)))
+	{
+		gie = __get_SR_register() & GIE;
+		__bic_SR_register(GIE);
+		if (xl_state == XL_IDLE)		// (ISR may have started it)
+		{
+			xl_left = 0;				// count again - FIFO may be full
+			xl_kick = 1;
+			xl_drain();
+		}
+		__bis_SR_register(gie);
+	}
+	return got;
+} // end xl_read
+
+
+//******************************************************************************
+//	OUT:	return number of samples waiting
+//
+uint8 xl_count(void)
+{
+	return (xl_head - xl_tail) & XL_RING_MASK;
+} // end xl_count
+
+
+//******************************************************************************
+//	stop sampling (ADXL345 standby, P1.4 interrupt off)
+//
+void xl_stop(void)
+{
+	P1IE &= ~ADXL345_INT;
+	while (xl_state != XL_IDLE);		// let drain finish
+	xl_write(XL_POWER_CTL, 0);
+	return;
+} // end xl_stop
+
+
+//******************************************************************************
+//	P1.4 (INT1) interrupt - FIFO at watermark (from PORT1 ISR)
+//
+void xl_port1_isr(void)
+{
+	P1IFG &= ~ADXL345_INT;
+	if (xl_state == XL_IDLE)			// else drain running
+	{
+		xl_kick = 1;
+		xl_drain();
+	}
+	return;
+} // end xl_port1_isr
@@ -0,0 +1,36 @@
+//******************************************************************************
+//	ADXL345 accelerometer (I2C, INT1 on P1.4 - RBX430_adxl345.c)
+//******************************************************************************
+#ifndef ADXL345_H_
+#define ADXL345_H_
+
+#define XL_ADDR				0x53		// i2c address (ALT ADDRESS low)
+#define XL_RING_SIZE		8			// samples buffered (power of 2)
+#define XL_WATERMARK		4			// FIFO samples per interrupt (< XL_RING_SIZE)
+
+//	output data rates (BW_RATE register)
+#define XL_RATE_25HZ		0x08
+#define XL_RATE_50HZ		0x09
+#define XL_RATE_100HZ		0x0a
+#define XL_RATE_200HZ		0x0b
+
+#define XL_1G				256			// sample value of 1 g (8.8 fixed point)
+
+typedef struct
+{
+	int16 x, y, z;						// g * XL_1G (~3.9mg resolution)
+} XL_SAMPLE;
+
+//	adxl345 prototypes
+uint8 xl_init(uint8 rate);
+uint8 xl_read(XL_SAMPLE* sample);
+uint8 xl_count(void);
+void xl_stop(void);
+
+//	PORT1 ISR (application) - call when P1IFG & ADXL345_INT
+void xl_port1_isr(void);
+
+extern volatile uint16 xl_lost;			// FIFO found full (samples overwritten)
+extern volatile uint16 xl_reads;		// i2c transactions
+
+#endif /*ADXL345_H_*/
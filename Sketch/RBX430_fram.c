@@ -0,0 +1,322 @@
+//	RBX430_fram.c - I2C FRAM driver
+//******************************************************************************
+//******************************************************************************
+//	Description:	FM24CL64B FRAM block storage for the RBX430-1 board
+//
+//	The FRAM is addressed once per transaction (2 address bytes) and then
+//	reads or writes sequentially with no write delay:
+//
+//		fram_read		one write/repeated start read transaction per
+//						FRAM_BURST bytes (i2c timeouts are per transaction)
+//		fram_write		one transaction per FRAM_CHUNK bytes (address and
+//						data are staged in one buffer - the i2c driver
+//						writes one buffer per transaction)
+//		fram_lcd		FRAM_LCD_WORDS per transaction, double buffered -
+//						the next read runs on the I2C interrupts while the
+//						last one is burst to the LCD (lcd_write_burst)
+//
+//	Named blobs (images, fonts, canvases) are kept in an allocation table
+//	at address 0 (FRAM_FILES entries of name, address, size).  Space is
+//	allocated first fit after the table; deleting a blob frees its space.
+//
+//	Throughput (test/test_fram.cpp, 6480 bytes at MCLK 8MHz - bus time
+//	and the Timer A polls, not the instructions between them):
+//
+//		I2C_FSCL	fram_read		fram_lcd		fram_write
+//		100kHz		11.0K/s			10.4K/s			10.1K/s
+//		200kHz		22.0K/s			20.8K/s			20.2K/s
+//		400kHz		43.1K/s			40.6K/s			39.4K/s
+//
+//	A full screen (54 x 160 LCD words, 17280 bytes) does not fit in the
+//	8K part; a 160 x 60 pixel image (6480 bytes) does (160ms at 400kHz).
+//******************************************************************************
+//
+#include <string.h>
+
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+#include "RBX430_lcd.h"
+#include "RBX430_fram.h"
+
+#define FRAM_MAGIC		0xf7a1			// table formatted
+#define FRAM_TABLE		2				// first table entry
+#define FRAM_DATA		(FRAM_TABLE + FRAM_FILES * sizeof(FRAM_FILE))
+#define FRAM_BURST_MS	((FRAM_BURST + 4) * 9 / 100 + I2C_TIMEOUT_MS)	// @100kHz
+
+typedef struct
+{
+	char name[FRAM_NAME];				// 0 padded (name[0] = 0 - free)
+	uint16 addr;						// first byte
+	uint16 size;						// bytes
+} FRAM_FILE;
+
+static uint8 fram_ready;				// table found
+
+
+//******************************************************************************
+//	start read transaction (FRAM address in at[2])
+//
+static uint8 fram_submit(I2C_XFER* xfer, uint8* at, uint16 addr,
+	void* data, uint16 count)
+{
+	at[0] = addr >> 8;
+	at[1] = addr & 0xff;
+	xfer->addr = FRAM_ADDR;
+	xfer->ms = FRAM_BURST_MS;
+	xfer->wdata = at;
+	xfer->wcount = 2;
+	xfer->rdata = data;
+	xfer->rcount = count;
+	xfer->done = 0;
+	return i2c_submit(xfer);
+} // end fram_submit
+
+
+//******************************************************************************
+//	read table entry
+//
+static uint8 fram_entry(uint8 i, FRAM_FILE* file)
+{
+	return fram_read(FRAM_TABLE + i * sizeof(FRAM_FILE), file,
+		sizeof(FRAM_FILE));
+} // end fram_entry
+
+
+//******************************************************************************
+//	find table entry by name
+//
+//	OUT:	return entry number (FRAM_FILES if not found)
+//
+static uint8 fram_lookup(const char* name, FRAM_FILE* file)
+{
+	uint8 i;
+
+	for (i = 0; i < FRAM_FILES; ++i)
+	{
+		if (fram_entry(i, file)) return FRAM_FILES;
+		if (file->name[0] && !strncmp(file->name, name, FRAM_NAME)) break;
+	}
+	return i;
+} // end fram_lookup
+
+
+//******************************************************************************
+//	FRAM functions:
+//
+//	uint8 fram_init(void)
+//	uint8 fram_format(void)
+//	uint8 fram_read(uint16 addr, void* data, uint16 count)
+//	uint8 fram_write(uint16 addr, const void* data, uint16 count)
+//	uint8 fram_lcd(uint16 addr, uint16 words)
+//	uint16 fram_find(const char* name, uint16* size)
+//	uint16 fram_create(const char* name, uint16 size)
+//	uint8 fram_delete(const char* name)
+//
+//	All wait for the I2C bus (CPU sleeps - interrupts must be enabled).
+//
+//******************************************************************************
+//	check for FRAM and allocation table (call after i2c_init) - a part
+//	without a table (new part) is formatted
+//
+//	OUT:	return 0 (SYS_ERR_FRAM if no FRAM)
+//
+uint8 fram_init(void)
+{
+	uint16 magic = 0;
+
+	fram_ready = 0;
+	if (fram_read(0, &magic, 2)) return SYS_ERR_FRAM;
+	if (magic != FRAM_MAGIC) return fram_format();
+	fram_ready = 1;
+	return 0;
+} // end fram_init
+
+
+//******************************************************************************
+//	empty allocation table (all blobs lost)
+//
+//	OUT:	return 0 (SYS_ERR_FRAM if bus error)
+//
+uint8 fram_format(void)
+{
+	FRAM_FILE file;
+	uint16 magic = FRAM_MAGIC;
+	uint8 i;
+
+	memset(&file, 0, sizeof(file));
+	for (i = 0; i < FRAM_FILES; ++i)
+	{
+		if (fram_write(FRAM_TABLE + i * sizeof(FRAM_FILE), &file,
+			sizeof(FRAM_FILE))) return SYS_ERR_FRAM;
+	}
+	if (fram_write(0, &magic, 2)) return SYS_ERR_FRAM;
+	fram_ready = 1;
+	return 0;
+} // end fram_format
+
+
+//******************************************************************************
+//	read count bytes from addr (FRAM_BURST bytes per transaction)
+//
+//	OUT:	return 0 (SYS_ERR_FRAM if bus error)
+//
+uint8 fram_read(uint16 addr, void* data, uint16 count)
+{
+	uint8* dst = (uint8*)data;
+	I2C_XFER xfer;
+	uint8 at[2];
+	uint16 n;
+
+	while (count)
+	{
+		n = (count < FRAM_BURST) ? count : FRAM_BURST;
+		while (fram_submit(&xfer, at, addr, dst, n));	// (queue full)
+		if (i2c_wait(&xfer)) return SYS_ERR_FRAM;
+		addr += n;
+		dst += n;
+		count -= n;
+	}
+	return 0;
+} // end fram_read
+
+
+//******************************************************************************
+//	write count bytes to addr (FRAM_CHUNK bytes per transaction)
+//
+//	OUT:	return 0 (SYS_ERR_FRAM if bus error)
+//
+uint8 fram_write(uint16 addr, const void* data, uint16 count)
+{
+	const uint8* src = (const uint8*)data;
+	uint8 buf[2 + FRAM_CHUNK];			// address + data
+	uint16 n;
+
+	while (count)
+	{
+		n = (count < FRAM_CHUNK) ? count : FRAM_CHUNK;
+		buf[0] = addr >> 8;
+		buf[1] = addr & 0xff;
+		memcpy(buf + 2, src, n);
+		if (i2c_write_read(FRAM_ADDR, buf, n + 2, 0, 0)) return SYS_ERR_FRAM;
+		addr += n;
+		src += n;
+		count -= n;
+	}
+	return 0;
+} // end fram_write
+
+
+//******************************************************************************
+//	stream LCD words from addr to the LCD
+//
+//	The LCD must be ready for data (lcd_set_window and RAMWR 0x5c).  Words
+//	are stored as lcd_write_burst takes them (uint16, low byte first).
+//
+//	IN:		words	LCD words to write
+//
+//	OUT:	return 0 (SYS_ERR_FRAM if bus error - rest not written)
+//
+uint8 fram_lcd(uint16 addr, uint16 words)
+{
+	uint16 buf[2][FRAM_LCD_WORDS];		// double buffer
+	I2C_XFER xfer[2];
+	uint8 at[2][2];
+	uint16 n, next;
+	uint8 b = 0;
+
+	n = (words < FRAM_LCD_WORDS) ? words : FRAM_LCD_WORDS;
+	if (!n) return 0;
+	while (fram_submit(&xfer[0], at[0], addr, buf[0], n * 2));
+	while (n)
+	{
+		if (i2c_wait(&xfer[b])) return SYS_ERR_FRAM;
+		addr += n * 2;
+		words -= n;
+		next = (words < FRAM_LCD_WORDS) ? words : FRAM_LCD_WORDS;
+		if (next)						// read next while this one is drawn
+		{
+			while (fram_submit(&xfer[b ^ 1], at[b ^ 1], addr, buf[b ^ 1],
+				next * 2));
+		}
+		lcd_write_burst(buf[b], n);
+		b ^= 1;
+		n = next;
+	}
+	return 0;
+} // end fram_lcd
+
+
+//******************************************************************************
+//	find named blob
+//
+//	OUT:	return FRAM address (0 if not found), *size = bytes (if size)
+//
+uint16 fram_find(const char* name, uint16* size)
+{
+	FRAM_FILE file;
+
+	if (!fram_ready || (fram_lookup(name, &file) == FRAM_FILES)) return 0;
+	if (size) *size = file.size;
+	return file.addr;
+} // end fram_find
+
+
+//******************************************************************************
+//	allocate named blob (first fit) - write it with fram_write
+//
+//	OUT:	return FRAM address (0 if name used, table full or no room)
+//
+uint16 fram_create(const char* name, uint16 size)
+{
+	FRAM_FILE file;
+	uint16 addr = FRAM_DATA;
+	uint8 i, slot = FRAM_FILES;
+
+	if (!fram_ready || !name[0] || (fram_lookup(name, &file) < FRAM_FILES))
+	{
+		return 0;
+	}
+	for (i = 0; i < FRAM_FILES; ++i)	// move past overlapping blobs
+	{
+		if (fram_entry(i, &file)) return 0;
+		if (!file.name[0])
+		{
+			if (slot == FRAM_FILES) slot = i;
+			continue;
+		}
+		if ((addr < file.addr + file.size) && (file.addr < addr + size))
+		{
+			addr = file.addr + file.size;
+			i = 0xff;					// (++i = 0) check all again
+		}
+	}
+	if ((slot == FRAM_FILES) || (size > FRAM_SIZE - addr)) return 0;
+
+	memset(&file, 0, sizeof(file));
+	strncpy(file.name, name, FRAM_NAME);
+	file.addr = addr;
+	file.size = size;
+	if (fram_write(FRAM_TABLE + slot * sizeof(FRAM_FILE), &file,
+		sizeof(FRAM_FILE))) return 0;
+	return addr;
+} // end fram_create
+
+
+//******************************************************************************
+//	delete named blob (space can be reused)
+//
+//	OUT:	return 0 (1 if not found)
+//
+uint8 fram_delete(const char* name)
+{
+	FRAM_FILE file;
+	uint8 i;
+
+	if (!fram_ready || ((i = fram_lookup(name, &file)) == FRAM_FILES))
+	{
+		return 1;
+	}
+	file.name[0] = 0;
+	return fram_write(FRAM_TABLE + i * sizeof(FRAM_FILE), &file, 1) ? 1 : 0;
+} // end fram_delete
@@ -0,0 +1,26 @@
+//******************************************************************************
+//	FRAM (FM24CL64B 8K x 8 on I2C - RBX430_fram.c)
+//******************************************************************************
+#ifndef FRAM_H_
+#define FRAM_H_
+
+#define FRAM_ADDR			0x50		// i2c address (A2-A0 low)
+#define FRAM_SIZE			8192		// bytes
+#define FRAM_FILES			16			// allocation table entries
+#define FRAM_NAME			8			// name characters (0 padded)
+#define FRAM_BURST			512			// bytes per read transaction
+#define FRAM_CHUNK			32			// bytes per write transaction
+#define FRAM_LCD_WORDS		32			// LCD words per read transaction
+
+//	fram prototypes
+uint8 fram_init(void);
+uint8 fram_format(void);
+uint8 fram_read(uint16 addr, void* data, uint16 count);
+uint8 fram_write(uint16 addr, const void* data, uint16 count);
+uint8 fram_lcd(uint16 addr, uint16 words);
+
+uint16 fram_find(const char* name, uint16* size);
+uint16 fram_create(const char* name, uint16 size);
+uint8 fram_delete(const char* name);
+
+#endif /*FRAM_H_*/
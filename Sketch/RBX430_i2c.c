@@ -0,0 +1,431 @@
+//	RBX430_i2c.c - USCI_B0 I2C master driver
+//******************************************************************************
+//******************************************************************************
+//	Description:	Interrupt driven I2C master for the RBX430-1 board
+//
+//	A transaction (I2C_XFER) writes wcount bytes and/or reads rcount bytes
+//	from one slave - write then read is done with a repeated start, so a
+//	register address and its data are one transaction.  i2c_submit queues
+//	it (up to I2C_QUEUE_SIZE) and returns at once; the USCI_B0 interrupts
+//	run it a byte per interrupt and start the next one, so the CPU can
+//	sleep (i2c_wait) or do other work meanwhile.
+//
+//	When a transaction ends its status is set (I2C_OK, SYS_ERR_I2C_ACK if
+//	the slave did not acknowledge, SYS_ERR_I2C_TO if it took longer than
+//	its timeout) and its done function is called from the ISR.  A done
+//	function may submit the next transaction.
+//
+//	Interrupts:	USCIAB0TX (shared with the UART) - data bytes
+//				USCIAB0RX (shared with the UART) - no acknowledge
+//				TIMERA1 (Timer A CCR1) - 1ms timeout ticks while busy,
+//					start/stop polls
+//
+//	Timer A is shared with telemetry (tm_init) - both run it free from
+//	SMCLK/8.  A timeout resets USCI_B0; a slave that still holds SDA low
+//	is not clocked free.
+//
+//	Every transaction ends on its stop condition, so a NACK of the last
+//	byte is reported by that transaction and the next one starts on an
+//	idle bus.  A single byte read must set its stop as soon as the start
+//	is acknowledged, so the byte is NACKed.  The master only flags these
+//	events in UCTXSTP/UCTXSTT clearing (no interrupt), and no ISR waits
+//	for them - CCR1 polls the bit every ~2 SCL clocks instead (i2c_poll),
+//	so a UART byte is never held up behind a stop.  A poll gives up after
+//	1ms - USCI_B0 is reset and the transaction ends SYS_ERR_I2C_TO.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+
+#define I2C_QUEUE_MASK	(I2C_QUEUE_SIZE - 1)
+
+extern uint16 mclk_kHz;					// MCLK = SMCLK (kHz)
+
+static I2C_XFER* i2c_q[I2C_QUEUE_SIZE];	// queued transactions
+static volatile uint8 i2c_q_head;		// next free (i2c_submit)
+static volatile uint8 i2c_q_tail;		// next to run (ISR)
+
+static I2C_XFER* volatile i2c_xfer;		// transaction running (0 = idle)
+static const uint8* i2c_wdata;			// 	next byte to write
+static uint16 i2c_wcount;
+static uint8* i2c_rdata;				// 	next byte to read
+static uint16 i2c_rcount;
+static uint8 i2c_ms;					// 	ms to timeout
+static uint8 i2c_status;				// 	status when stop is sent
+static uint8 i2c_wait_bit;				// 	UCTXSTT/UCTXSTP polled (0 = none)
+static uint16 i2c_polls;				// 	polls to give up
+static uint16 i2c_ticks_ms;				// Timer A ticks per ms
+static uint16 i2c_ticks_poll;			// Timer A ticks per poll (~2 SCL)
+
+
+static uint8 i2c_finish(uint8 status);
+
+
+//******************************************************************************
+//	reset USCI_B0 (abandon bus)
+//
+static void i2c_reset(void)
+{
+	UCB0CTL1 |= UCSWRST;
+	UCB0CTL1 &= ~UCSWRST;
+	UCB0I2CIE = UCNACKIE;
+	return;
+} // end i2c_reset
+
+
+//******************************************************************************
+//	poll UCTXSTT or UCTXSTP from CCR1 until it clears (TIMERA1_ISR)
+//
+//	IN:		bit		UCTXSTT or UCTXSTP
+//
+static void i2c_poll(uint8 bit)
+{
+	i2c_wait_bit = bit;
+	i2c_polls = i2c_ticks_ms / i2c_ticks_poll + 1;	// (~1ms)
+	TACCR1 = TAR + i2c_ticks_poll;
+	return;
+} // end i2c_poll
+
+
+//******************************************************************************
+//	end transaction on its stop (UCTXSTP set by caller)
+//
+//	IN:		status	transaction status once the stop is sent
+//
+//	OUT:	return 0 (not done yet)
+//
+static uint8 i2c_stop(uint8 status)
+{
+	IE2 &= ~(UCB0TXIE + UCB0RXIE);
+	i2c_status = status;
+	i2c_poll(UCTXSTP);
+	return 0;
+} // end i2c_stop
+
+
+//******************************************************************************
+//	start receive (after start/repeated start address is sent)
+//
+//	A single byte read polls for the start to be acknowledged, then sets
+//	the stop (TIMERA1_ISR) and enables the receive interrupt.
+//
+//	OUT:	return 0
+//
+static uint8 i2c_start_read(void)
+{
+	UCB0CTL1 &= ~UCTR;					// receiver
+	UCB0CTL1 |= UCTXSTT;				// (repeated) start
+	if (i2c_rcount == 1)
+	{
+		i2c_poll(UCTXSTT);				// address acknowledged?
+		return 0;
+	}
+	IE2 |= UCB0RXIE;
+	return 0;
+} // end i2c_start_read
+
+
+//******************************************************************************
+//	start next queued transaction (interrupts disabled)
+//
+static void i2c_next(void)
+{
+	I2C_XFER* xfer;
+
+	if (i2c_q_tail == i2c_q_head)		// queue empty
+	{
+		TACCTL1 = 0;					// no timeout ticks
+		return;
+	}
+	i2c_xfer = xfer = i2c_q[i2c_q_tail];
+	i2c_q_tail = (i2c_q_tail + 1) & I2C_QUEUE_MASK;
+
+	i2c_wdata = xfer->wdata;
+	i2c_wcount = xfer->wcount;
+	i2c_rdata = xfer->rdata;
+	i2c_rcount = xfer->rcount;
+	i2c_ms = xfer->ms ? xfer->ms : I2C_TIMEOUT_MS;
+	i2c_wait_bit = 0;
+	TACCR1 = TAR + i2c_ticks_ms;		// timeout ticks
+	TACCTL1 = CCIE;
+
+	UCB0STAT &= ~UCNACKIFG;				// (none left from the last one)
+	UCB0I2CSA = xfer->addr;
+	if (!i2c_wcount && i2c_rcount)		// read only
+	{
+		i2c_start_read();
+		return;
+	}
+	UCB0CTL1 |= UCTR + UCTXSTT;			// transmitter, start
+	IE2 |= UCB0TXIE;					// (TXIFG set - first byte now)
+	return;
+} // end i2c_next
+
+
+//******************************************************************************
+//	end running transaction and start next
+//
+//	OUT:	return 1 (wake main loop)
+//
+static uint8 i2c_finish(uint8 status)
+{
+	I2C_XFER* xfer = i2c_xfer;
+
+	IE2 &= ~(UCB0TXIE + UCB0RXIE);
+	i2c_wait_bit = 0;
+	i2c_xfer = 0;
+	xfer->status = status;
+	if (xfer->done) xfer->done(xfer);	// (may submit - starts if idle)
+	if (!i2c_xfer) i2c_next();
+	return 1;
+} // end i2c_finish
+
+
+//******************************************************************************
+//	I2C functions:
+//
+//	uint16 i2c_init(uint16 kHz)
+//	uint8 i2c_submit(I2C_XFER* xfer)
+//	uint8 i2c_wait(I2C_XFER* xfer)
+//	uint8 i2c_transfer(I2C_XFER* xfer)
+//	uint8 i2c_write_read(uint8 addr, const uint8* wdata, uint16 wcount,
+//		uint8* rdata, uint16 rcount)
+//	uint8 i2c_busy(void)
+//
+//******************************************************************************
+//	initialize USCI_B0 I2C master (call after RBX430_init, queue idle)
+//
+//	IN:		kHz		SCL rate - 100, 200 or 400 (0 = I2C_FSCL)
+//
+//	OUT:	return SCL rate (kHz) - SMCLK / divider, never faster than
+//			asked unless limited by I2C_MIN_DIV (400kHz @1MHz = 250kHz)
+//
+uint16 i2c_init(uint16 kHz)
+{
+	uint16 div;
+
+	if (kHz == 0) kHz = I2C_FSCL;
+	div = (mclk_kHz + kHz - 1) / kHz;	// round up (slower)
+	if (div < I2C_MIN_DIV) div = I2C_MIN_DIV;
+
+	UCB0CTL1 = UCSSEL_2 + UCSWRST;		// SMCLK, hold in reset
+	UCB0CTL0 = UCMST + UCMODE_3 + UCSYNC;	// I2C master
+	UCB0BR0 = div & 0xff;
+	UCB0BR1 = div >> 8;
+	P3SEL |= SDA + SCL;					// P3.1 UCB0SDA, P3.2 UCB0SCL
+	i2c_q_head = i2c_q_tail = 0;
+	i2c_xfer = 0;
+	UCB0CTL1 &= ~UCSWRST;				// release USCI
+	UCB0I2CIE = UCNACKIE;				// no acknowledge interrupt
+
+	if (!(TACTL & MC_2)) TACTL = TASSEL_2 + ID_3 + MC_2;	// SMCLK/8
+	i2c_ticks_ms = mclk_kHz >> 3;
+	i2c_ticks_poll = div >> 2;			// ~2 SCL clocks (8 SMCLK/tick)
+	if (i2c_ticks_poll < 2) i2c_ticks_poll = 2;	// (TACCR1 ahead of TAR)
+	i2c_wait_bit = 0;
+	TACCTL1 = 0;
+	return mclk_kHz / div;
+} // end i2c_init
+
+
+//******************************************************************************
+//	queue transaction (starts at once if bus idle - ISR safe)
+//
+//	OUT:	return 0 (1 if queue full - not queued)
+//
+uint8 i2c_submit(I2C_XFER* xfer)
+{
+	uint16 gie = __get_SR_register() & GIE;
+	uint8 next;
+
+	__bic_SR_register(GIE);
+	next = (i2c_q_head + 1) & I2C_QUEUE_MASK;
+	if (next == i2c_q_tail)
+	{
+		__bis_SR_register(gie);
+		return 1;						// full
+	}
+	xfer->status = I2C_BUSY;
+	i2c_q[i2c_q_head] = xfer;
+	i2c_q_head = next;
+	if (!i2c_xfer) i2c_next();			// bus idle - start
+	__bis_SR_register(gie);
+	return 0;
+} // end i2c_submit
+
+
+//******************************************************************************
+//	sleep (LPM0) until transaction is done (interrupts are enabled while
+//	asleep, then restored)
+//
+//	OUT:	return transaction status
+//
+uint8 i2c_wait(I2C_XFER* xfer)
+{
+	uint16 gie = __get_SR_register() & GIE;
+
+	while (1)
+	{
+		__bic_SR_register(GIE);			// (no wake up between test and sleep)
+		if (xfer->status != I2C_BUSY) break;
+		__bis_SR_register(LPM0_bits + GIE);	// sleep - ISRs wake
+	}
+	__bis_SR_register(gie);				// (caller's GIE)
+	return xfer->status;
+} // end i2c_wait
+
+
+//******************************************************************************
+//	run transaction and wait for it (waits while queue is full)
+//
+//	OUT:	return transaction status
+//
+uint8 i2c_transfer(I2C_XFER* xfer)
+{
+	while (i2c_submit(xfer));			// (ISR makes room)
+	return i2c_wait(xfer);
+} // end i2c_transfer
+
+
+//******************************************************************************
+//	write wcount bytes then read rcount bytes from addr (waits)
+//
+//	OUT:	return I2C_OK, SYS_ERR_I2C_ACK or SYS_ERR_I2C_TO
+//
+uint8 i2c_write_read(uint8 addr, const uint8* wdata, uint16 wcount,
+	uint8* rdata, uint16 rcount)
+{
+	I2C_XFER xfer;
+
+	xfer.addr = addr;
+	xfer.ms = 0;
+	xfer.wdata = wdata;
+	xfer.wcount = wcount;
+	xfer.rdata = rdata;
+	xfer.rcount = rcount;
+	xfer.done = 0;
+	return i2c_transfer(&xfer);
+} // end i2c_write_read
+
+
+//******************************************************************************
+//	OUT:	return 1 if a transaction is queued or running
+//
+uint8 i2c_busy(void)
+{
+	return (i2c_xfer != 0);
+} // end i2c_busy
+
+
+//******************************************************************************
+//	USCI_B0 data interrupt (from USCIAB0TX_ISR)
+//
+//	TXIFG: next byte, repeated start for the read, or stop.  The last
+//		byte is in the shift register - the transaction ends on the
+//		stop, I2C_OK unless that byte was not acknowledged.
+//	RXIFG: store byte - stop is set when one byte is left so it is NACKed.
+//
+//	Nothing here waits - stops are polled by TIMERA1_ISR.
+//
+//	OUT:	return 1 if transaction done
+//
+uint8 i2c_data_isr(void)
+{
+	if (IFG2 & UCB0RXIFG)
+	{
+		if (!i2c_rcount)				// (byte after a late stop)
+		{
+			UCB0RXBUF;					// discard (clears UCB0RXIFG)
+			return 0;
+		}
+		*i2c_rdata++ = UCB0RXBUF;		// (clears UCB0RXIFG)
+		if (--i2c_rcount == 1) UCB0CTL1 |= UCTXSTP;
+		if (i2c_rcount == 0) return i2c_stop(I2C_OK);
+		return 0;
+	}
+	if (i2c_wcount)
+	{
+		UCB0TXBUF = *i2c_wdata++;		// (clears UCB0TXIFG)
+		--i2c_wcount;
+		return 0;
+	}
+	IFG2 &= ~UCB0TXIFG;
+	IE2 &= ~UCB0TXIE;
+	if (i2c_rcount)						// write done - now read
+	{
+		return i2c_start_read();
+	}
+	UCB0CTL1 |= UCTXSTP;				// stop after last byte
+	return i2c_stop(I2C_OK);
+} // end i2c_data_isr
+
+
+//******************************************************************************
+//	USCI_B0 state interrupt (from USCIAB0RX_ISR) - no acknowledge
+//
+//	OUT:	return 1 if transaction done
+//
+uint8 i2c_state_isr(void)
+{
+	UCB0STAT &= ~UCNACKIFG;
+	UCB0CTL1 |= UCTXSTP;				// give up - stop
+	IFG2 &= ~UCB0TXIFG;
+	if (!i2c_xfer) return 0;			// (none running)
+	return i2c_stop(SYS_ERR_I2C_ACK);
+} // end i2c_state_isr
+
+
+//******************************************************************************
+//	Timer A CCR1 interrupt - start/stop polls, transaction timeout
+//
+//	Polling UCTXSTT: start acknowledged - set the stop so the single byte
+//		read is NACKed, then back to 1ms ticks.
+//	Polling UCTXSTP: stop sent - the transaction ends (SYS_ERR_I2C_ACK if
+//		a NACK came meanwhile).
+//	Either gives up after ~1ms (USCI_B0 reset, SYS_ERR_I2C_TO).
+//
+#pragma vector = TIMERA1_VECTOR
+__interrupt void TIMERA1_ISR(void)
+{
+	uint8 status;
+
+	if (TAIV != TAIV_TACCR1) return;	// (CCR2/overflow not used)
+	if (i2c_wait_bit)					// start/stop poll
+	{
+		if (UCB0CTL1 & i2c_wait_bit)	// not yet
+		{
+			TACCR1 += i2c_ticks_poll;
+			if (--i2c_polls) return;
+			i2c_reset();				// (bus stuck)
+			status = SYS_ERR_I2C_TO;
+		}
+		else if (i2c_wait_bit == UCTXSTT)
+		{
+			UCB0CTL1 |= UCTXSTP;		// NACK + stop after 1 byte
+			IE2 |= UCB0RXIE;
+			i2c_wait_bit = 0;
+			TACCR1 = TAR + i2c_ticks_ms;
+			return;
+		}
+		else
+		{
+			status = i2c_status;
+			if (UCB0STAT & UCNACKIFG)	// (state interrupt not served yet)
+			{
+				UCB0STAT &= ~UCNACKIFG;
+				status = SYS_ERR_I2C_ACK;
+			}
+		}
+		i2c_finish(status);				// (next starts with 1ms ticks)
+		__bic_SR_register_on_exit(CPUOFF);	// wake main loop
+		return;
+	}
+	TACCR1 += i2c_ticks_ms;
+	if (!i2c_xfer || --i2c_ms) return;
+
+	i2c_reset();
+	i2c_finish(SYS_ERR_I2C_TO);
+	__bic_SR_register_on_exit(CPUOFF);	// wake main loop
+	return;
+} // end TIMERA1_ISR
@@ -0,0 +1,42 @@
+//******************************************************************************
+//	I2C master (USCI_B0 - P3.1 SDA, P3.2 SCL - RBX430_i2c.c)
+//******************************************************************************
+#ifndef I2C_H_
+#define I2C_H_
+
+#define I2C_QUEUE_SIZE		4			// queued transactions (power of 2)
+#define I2C_TIMEOUT_MS		10			// default transaction timeout
+#define I2C_MIN_DIV			4			// SMCLK clocks per SCL (USCI minimum)
+
+//	transaction status (SYS_ERR_I2C_ACK/SYS_ERR_I2C_TO if failed)
+#define I2C_OK				0			// done
+#define I2C_BUSY			0xff		// queued or running
+
+//	transaction - write wcount bytes, then (repeated start) read rcount
+//	bytes.  Owned by the caller; must not change until status != I2C_BUSY.
+typedef struct I2C_XFER
+{
+	uint8 addr;							// 7 bit slave address
+	uint8 ms;							// timeout (0 = I2C_TIMEOUT_MS)
+	uint16 wcount;						// bytes to write
+	const uint8* wdata;
+	uint16 rcount;						// bytes to read
+	uint8* rdata;
+	void (*done)(struct I2C_XFER* xfer);	// called from ISR when done (or 0)
+	volatile uint8 status;				// I2C_BUSY, I2C_OK or error
+} I2C_XFER;
+
+//	i2c prototypes
+uint16 i2c_init(uint16 kHz);
+uint8 i2c_submit(I2C_XFER* xfer);
+uint8 i2c_wait(I2C_XFER* xfer);
+uint8 i2c_transfer(I2C_XFER* xfer);
+uint8 i2c_write_read(uint8 addr, const uint8* wdata, uint16 wcount,
+	uint8* rdata, uint16 rcount);
+uint8 i2c_busy(void);
+
+//	USCIAB0 ISRs (RBX430_uart.c) - return 1 to wake main loop
+uint8 i2c_data_isr(void);
+uint8 i2c_state_isr(void);
+
+#endif /*I2C_H_*/
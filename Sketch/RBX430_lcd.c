@@ -21,7 +21,6 @@
 //	Built with CCSv5.2 w/cgt 3.0.0
 //******************************************************************************
 //
-#include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
@@ -33,8 +32,27 @@
 static uint16 lcd_dmode;			// lcd mode
 static uint8 lcd_y;					// row (0-159)
 static uint8 lcd_x;					// column (0-159)
+uint8 lcd_epoch;					// incremented by lcd_set (hud, sprites)
+static uint8 lcd_start;				// scroll start line (multiple of 4)
+
+//	controller address tracking (see lcd_set_window)
+#define WIN_LINES		0x01
+#define WIN_COLUMNS		0x02
+
+static uint8 lcd_win;				// window axes known (WIN_LINES|WIN_COLUMNS)
+static uint8 lcd_home;				// address counter at window start
+static uint8 lcd_line0, lcd_line1;	// window lines
+static uint8 lcd_col0, lcd_col1;	// window columns
+static uint8 lcd_stream;			// RAMWR/RAMRD open for lcd_write/read_word
+static uint8 lcd_ptr_col;			// 	next stream address
+static uint8 lcd_ptr_line;
+static uint8 lcd_word_valid;		// lcd_word is window start word
+static uint16 lcd_word;				// 	(last lcd_point word)
+static uint8 lcd_word_col;
+static uint8 lcd_word_line;
 
 extern uint16 i2c_fSCL;				// i2c timing constant
+extern uint16 mclk_kHz;				// MCLK (kHz)
 
 #define DELAY_1MS	1000
 
@@ -43,6 +61,7 @@ int ReadData(void);
 void WriteData(uint8 c);
 void WriteData_word(uint16 data);
 void DelayMs(uint16 time);
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1);
 
 //******************************************************************************
 //******************************************************************************
@@ -99,6 +118,14 @@ uint8 lcd_init(void)
 
 	WriteCmd(0xa6);				// Normal Display
 
+	WriteCmd(0xaa);				// Area Scroll Set
+		WriteData(0x00);		// top block 0
+		WriteData(0x27);		// bottom block 39
+		WriteData(0x27);		// 40 blocks
+		WriteData(0x03);		// whole screen scroll
+	WriteCmd(0xab);				// Scroll Start Set
+		WriteData(0x00);		// block 0 (no scroll)
+
 	WriteCmd(0xbb);				// COM Scan Direction
 		WriteData(0x01);		// 0->79 159->80
 
@@ -127,6 +154,10 @@ uint8 lcd_init(void)
 	lcd_dmode = 0;
 	lcd_y = HD_Y_MAX - 1;
 	lcd_x = 0;					// column (0-159)
+	lcd_start = 0;
+	lcd_win = 0;				// controller address unknown
+	lcd_home = 0;
+	lcd_word_valid = 0;
 	return 0;
 } // end  lcd_init
 
@@ -149,6 +180,25 @@ uint8 lcd_init(void)
 //
 void WriteCmd(uint8 c)
 {
+	lcd_stream = 0;		// ends lcd_read/write_word stream
+	switch (c)
+	{
+		case 0x75:		// line/column window changing
+			lcd_win &= ~WIN_LINES;
+			lcd_word_valid = 0;
+			break;
+		case 0x15:
+			lcd_win &= ~WIN_COLUMNS;
+			// fall through - lcd_word no longer at window start
+		case 0xe0:		// RAM about to be written
+			lcd_word_valid = 0;
+			break;
+		case 0x5c:		// stream moves address counter
+		case 0x5d:
+			lcd_word_valid = 0;
+			lcd_home = 0;
+			break;
+	}
 	P2DIR = 0xff;		// output to P2
 	P2OUT = c;			// set data on output lines
 	LCD_RW_L;			// set RW low (write)
@@ -255,55 +305,112 @@ unsigned divu3(unsigned n)
 } // end divu3
 
 
+//******************************************************************************
+//	set controller window
+//
+//	The line (0x75) and column (0x15) window commands cost 3 bus writes each,
+//	so the window is remembered and only the axes that change are sent.
+//	WriteCmd forgets an axis whenever anyone else sends its command.
+//
+//	Address tracking assumes the lcd_init data scan direction (0xbc):
+//	column address increments first, then line, within the window, and
+//	RAMWR/RAMRD restart at the window start.  After a RAMWR/RAMRD stream
+//	the address counter is somewhere in the window, so both axes are sent;
+//	read-modify-write (RMWOUT) returns it to the start.
+//
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1)
+{
+	if (!lcd_home) lcd_win = 0;		// address counter moved - send both
+	lcd_home = 1;
+	if (!(lcd_win & WIN_LINES) || (line0 != lcd_line0) || (line1 != lcd_line1))
+	{
+		WriteCmd(0x75);				// set line address
+			WriteData(line0);
+			WriteData(line1);
+		lcd_line0 = line0;
+		lcd_line1 = line1;
+		lcd_win |= WIN_LINES;
+	}
+	if (!(lcd_win & WIN_COLUMNS) || (col0 != lcd_col0) || (col1 != lcd_col1))
+	{
+		WriteCmd(0x15);				// set column address
+			WriteData(col0);
+			WriteData(col1);
+		lcd_col0 = col0;
+		lcd_col1 = col1;
+		lcd_win |= WIN_COLUMNS;
+	}
+	return;
+} // end lcd_set_window
+
+
 //******************************************************************************
 //	set lcd x, y
 //
 void lcd_set_x_y(uint8 x, uint8 y)
 {
-	WriteCmd(0x75);					// set line address
-		WriteData(y);				// from line 0 - 159
-		WriteData(0x9f);
-
-	WriteCmd(0x15);					// set column address
-		WriteData(divu3(x));		// from col 0 - 160/3
-		WriteData(0x35);
+	lcd_set_window(divu3(x), 0x35, y, 0x9f);	// col 0 - 160/3, line 0 - 159
 	return;
 } // end lcd_set_x_y
 
 
+//	next lcd_read/write_word stream address (column, then line)
+//
+static void lcd_stream_next(uint8 column, uint8 row)
+{
+	if (++column > lcd_col1)
+	{
+		column = lcd_col0;
+		if (++row > lcd_line1) row = lcd_line0;
+	}
+	lcd_ptr_col = column;
+	lcd_ptr_line = row;
+	return;
+} // end lcd_stream_next
+
+
 //******************************************************************************
 //	lcd read word
 //
+//	Sequential reads (next column) continue the open RAMRD without any
+//	window commands.
+//
 uint16 lcd_read_word(int16 column, int16 row)
 {
-	WriteCmd(0x75);					// set line address
-		WriteData(row);				// from line 0 - 159
-		WriteData(0x9f);
-
-	WriteCmd(0x15);					// set column address
-		WriteData(column);			// from col 0 - 160
-		WriteData(0x35);
-	WriteCmd(0x5d);					// RAMRD - read from memory
-	ReadData();						// Dummy read
-	return (ReadData() << 8) + ReadData();
+	uint16 data;
+
+	if ((lcd_stream != 0x5d) || (column != lcd_ptr_col) || (row != lcd_ptr_line))
+	{
+		lcd_set_window(column, 0x35, row, 0x9f);
+		WriteCmd(0x5d);					// RAMRD - read from memory
+		ReadData();						// Dummy read
+		lcd_stream = 0x5d;
+	}
+	data = ReadData() << 8;
+	data += ReadData();
+	lcd_stream_next(column, row);
+	return data;
 } // end lcd_read_word
 
 
 //******************************************************************************
 //	lcd write word
 //
+//	Sequential writes (next column) continue the open RAMWR without any
+//	window commands.
+//
 void lcd_write_word(int16 column, int16 row, uint16 data)
 {
-	WriteCmd(0x75);					// set line address
-		WriteData(row);				// from line 0 - 159
-		WriteData(0x9f);
-
-	WriteCmd(0x15);					// set column address
-		WriteData(column);			// from col 0 - 160
-		WriteData(0x35);
-	WriteCmd(0x5c);					// RAMWR - write to memory
-	WriteData(data >> 8);			// write high byte
-	WriteData(data & 0x00ff);		// write low byte
+	if ((lcd_stream != 0x5c) || (column != lcd_ptr_col) || (row != lcd_ptr_line))
+	{
+		lcd_set_window(column, 0x35, row, 0x9f);
+		WriteCmd(0x5c);					// RAMWR - write to memory
+		lcd_stream = 0x5c;
+	}
+	WriteData(data >> 8);				// write high byte
+	WriteData(data & 0x00ff);			// write low byte
+	lcd_word_valid = 0;					// may be lcd_point's word
+	lcd_stream_next(column, row);
 	return;
 } // end lcd_write_word
 
@@ -322,22 +429,130 @@ void lcd_clear()
 //
 void lcd_set(uint16 value)
 { 
-	int i; 
+	lcd_set_lines(value, 0, HD_Y_MAX);	// whole screen - rows x columns
+	lcd_set_done();
+	return;
+} // end  lcd_set
+
 
-	lcd_set_x_y(0, 0);			// upper right corner
+//******************************************************************************
+//	set lcd RAM lines line to line + count - 1 (54 words per line)
+//
+void lcd_set_lines(uint16 value, int16 line, int16 count)
+{
+	if (count <= 0) return;
+	lcd_set_x_y(0, line);		// full width from line
 	WriteCmd(0x5c);				// start write
+	lcd_write_repeat(value, count * 54);
+	return;
+} // end lcd_set_lines
 
-	// whole screen - rows x columns
-//	for (i = 0; i < 160 * (divu3((160*2))); i++)
-	for (i = 160 * (divu3((160*2))); i > 0; --i)
-	{
-		WriteData_word(value);
-	} 
-	lcd_dmode = 0;				// reset mode
+
+//******************************************************************************
+//	finish screen set - reset mode, cursor and scroll (lcd_set_lines done)
+//
+void lcd_set_done(void)
+{
+	lcd_dmode &= LCD_REVERSE_DISPLAY;	// reset mode (display stays reversed)
 	lcd_y = HD_Y_MAX - 1;		// upper left hand corner
 	lcd_x = 0;
+	++lcd_epoch;				// hud/sprite saved data is stale
+	if (lcd_start)
+	{
+		WriteCmd(0xab);			// Scroll Start Set
+			WriteData(0x00);	// back to block 0
+		lcd_start = 0;
+	}
 	return;
-} // end  lcd_set
+} // end  lcd_set_done
+
+
+//******************************************************************************
+//	hardware vertical scroll
+//
+//	The ST7529 is set up (lcd_init) to scroll the whole screen in 4 line
+//	blocks.  Display row y (0 = bottom) shows RAM line (y + lcd_start) % 160,
+//	so scrolling is one Scroll Start Set command plus blanking the lines
+//	that come into view - the rest of the screen is not rewritten.
+//
+//	lines > 0	move contents up (blank lines enter at the bottom)
+//	lines < 0	move contents down (blank lines enter at the top)
+//
+//	Lines are rounded to a multiple of 4.  Only characters written with
+//	lcd_putchar in LCD_SCROLL_TEXT mode follow the scroll; other drawing
+//	uses RAM lines and should map rows with lcd_scroll_line.
+//
+static void lcd_blank_lines(int16 line, int16 count)
+{
+	if (count <= 0) return;
+	if (line + count > HD_Y_MAX)			// wraps past line 159
+	{
+		lcd_blank_lines(0, line + count - HD_Y_MAX);
+		count = HD_Y_MAX - line;
+	}
+	lcd_set_lines(0xffdf, line, count);		// 3 pixels off
+	return;
+} // end lcd_blank_lines
+
+
+void lcd_scroll(int16 lines)
+{
+	int16 start = lcd_start;
+
+	lines = (lines + 3) & ~3;				// whole blocks
+	if ((lines >= HD_Y_MAX) || (lines <= -HD_Y_MAX))
+	{
+		lcd_blank_lines(0, HD_Y_MAX);		// everything scrolled off
+		return;
+	}
+	if (lines > 0)
+	{
+		start -= lines;						// bottom lines come into view
+		if (start < 0) start += HD_Y_MAX;
+		lcd_blank_lines(start, lines);
+	}
+	else if (lines < 0)
+	{
+		lcd_blank_lines(start, -lines);		// top lines come into view
+		start -= lines;
+		if (start >= HD_Y_MAX) start -= HD_Y_MAX;
+	}
+	lcd_start = start;
+	WriteCmd(0xab);							// Scroll Start Set
+		WriteData(start >> 2);				// 4 line block
+	return;
+} // end lcd_scroll
+
+
+//	map display row (0 = bottom) to the RAM line currently showing it
+//
+uint8 lcd_scroll_line(int16 y)
+{
+	y += lcd_start;
+	if (y >= HD_Y_MAX) y -= HD_Y_MAX;
+	return y;
+} // end lcd_scroll_line
+
+
+//	LCD_SCROLL_TEXT new line - move down a text line or scroll the
+//	screen up when the cursor is on the bottom text line
+//
+//	Text rows are whole text lines up from the bottom, so a character
+//	(lcd_y is its lower left corner) never straddles RAM line 159 -
+//	lcd_point would clip the part past it.
+//
+static void lcd_newline(void)
+{
+	int16 height = (lcd_dmode & LCD_2X_FONT) ? CHAR_SIZE * 2 : CHAR_SIZE;
+	int16 row = lcd_y - lcd_start;			// cursor display row
+	if (row < 0) row += HD_Y_MAX;
+
+	row -= row % height;					// text row the cursor is in
+	if (row < height) lcd_scroll(height);	// bottom line - scroll up
+	else row -= height;
+	lcd_y = lcd_scroll_line(row);
+	return;
+} // end lcd_newline
 
 
 //******************************************************************************
@@ -496,99 +711,268 @@ uint8 lcd_bitImage(const uint8* image, int16 x, int16 y, uint8 flag)
 //
 uint8 lcd_wordImage(const uint16* image, int16 x, int16 y, uint8 flag)
 {
-	int16 x1;
-	int16 runCnt = 0;
-	uint16 runPixels;
+	LCD_JOB job;
+
+	lcd_job_image(&job, image, x, y, flag);
+	lcd_job_run(&job, 0);				// all rows
+	return 0;
+} // end lcd_wordImage
+
+
+//******************************************************************************
+//	Fill Image
+//
+//	IN:		x, y			lower right coordinates
+//			width,height	area to blank
+//			flag = 0		blank image
+//	    		   1		(unused)
+//	    		   2		fill image area
+//
+//	OUT:	return 0;
+//
+uint8 lcd_fill(int16 x, int16 y, uint16 width, uint16 height, uint8 flag)
+{
+	LCD_JOB job;
+
+	lcd_job_fill(&job, x, y, width, height, flag);
+	lcd_job_run(&job, 0);				// all rows
+	return 0;
+} // end lcd_fill
+
+
+//******************************************************************************
+//	Resumable LCD jobs:
+//
+//	void lcd_job_clear(LCD_JOB* job)
+//	void lcd_job_image(LCD_JOB* job, const uint16* image, int16 x, int16 y,
+//		uint8 flag)
+//	void lcd_job_fill(LCD_JOB* job, int16 x, int16 y, uint16 width,
+//		uint16 height, uint8 flag)
+//	uint8 lcd_job_run(LCD_JOB* job, uint16 us)
+//
+//	A job is a clear, lcd_wordImage or lcd_fill that is drawn a few rows
+//	per lcd_job_run call, so a main loop can keep sampling input while a
+//	splash screen or large fill is drawn.  The job holds everything needed
+//	to resume - next row, image source pointer and run decode state.
+//
+//	Image words are decoded from chunks - a flash image is one chunk; an
+//	image stream (lcd_stream.c) hands out chunks as they are fetched.
+//
+//	lcd_job_run stops when the next rows would exceed us microseconds
+//	(at least one row is drawn per call).  Times are estimated from MCLK
+//	(set by RBX430_init) and these costs:
+//
+#define LCD_JOB_ROW		300				// cycles to start rows (window, RAMWR)
+#define LCD_JOB_SOLID	16				// cycles per blank/fill word
+#define LCD_JOB_IMAGE	40				// cycles per image word (decode + burst)
+
+//******************************************************************************
+//	set up clear job (finishes like lcd_clear)
+//
+void lcd_job_clear(LCD_JOB* job)
+{
+	job->image = 0;
+	job->count = 0;
+	job->stream = 0;
+	job->runCnt = 0;
+	job->top = HD_Y_MAX - 1;			// all lines
+	job->bottom = -1;
+	job->col = 0;
+	job->words = 54;
+	job->flag = 0;						// 3 pixels off
+	job->clear = 1;
+	return;
+} // end lcd_job_clear
+
+
+//******************************************************************************
+//	set up lcd_wordImage job (same arguments)
+//
+void lcd_job_image(LCD_JOB* job, const uint16* image, int16 x, int16 y,
+	uint8 flag)
+{
+	uint16 width = *image++;			// get width/height
+	uint16 height = *image++;
+
+	lcd_job_fill(job, x, y, width, height, flag);
+	job->image = image;
+	job->count = 0xffff;				// (one chunk)
+	return;
+} // end lcd_job_image
 
-	int16 width = *image++;				// get width/height
-	int16 height = *image++;
-	int16 bottom = y;
 
+//******************************************************************************
+//	set up lcd_fill job (same arguments)
+//
+void lcd_job_fill(LCD_JOB* job, int16 x, int16 y, uint16 width,
+	uint16 height, uint8 flag)
+{
 	x += width - 1;						// move to top, left (make 0 based)
-	y += height;
-//	width = divu3((width + 2));			// 3 pixels per 2 bytes (round up)
+	job->image = 0;
+	job->count = 0;
+	job->stream = 0;
+	job->runCnt = 0;
+	job->top = y + height;				// display from top down
+	job->bottom = y;
+	job->col = divu3(159 - x);			// upper right corner
+	job->words = divu3((width + 2));	// 3 pixels per 2 bytes (round up)
+	job->flag = flag;
+	job->clear = 0;
+	return;
+} // end lcd_job_fill
 
-	while (y > bottom)					// display from top down
+
+//******************************************************************************
+//	get next chunk of image words
+//
+//	OUT:	return chunk, *count = words (a stream that failed or ran out
+//			gives 255 word runs of 3 pixels off)
+//
+static const uint16* lcd_job_next(LCD_JOB* job, uint16* count)
+{
+	static const uint16 lcd_off_run = 0xffff;	// ccff, 255 words
+	const uint16* image = 0;
+
+	if (job->stream) image = job->stream->next(job->stream, count);
+	if (!image)
 	{
-		lcd_set_x_y(159 - x, y);		// upper right corner
-		WriteCmd(0x5c);					// write to memory
+		image = &lcd_off_run;
+		*count = 1;
+	}
+	return image;
+} // end lcd_job_next
+
+
+//******************************************************************************
+//	output one row of a lcd_wordImage job (runs may continue to next row)
+//
+static void lcd_job_row(LCD_JOB* job)
+{
+	const uint16* image = job->image;
+	uint16 count = job->count;
+	uint16 runCnt = job->runCnt;
+	uint16 x1, n;
+
+	lcd_set_window(job->col, 0x35, job->top, 0x9f);
+	WriteCmd(0x5c);						// write to memory
 
-//		for (x1 = width; x1 > 0; --x1)			// display from right to left
-		for (x1 = width; x1 > 0; x1 -= 3)			// display from right to left
+	// display from right to left
+	for (x1 = job->words; x1 > 0; x1 -= n)
+	{
+		// output run of 3 pixels
+		if (runCnt)
 		{
-			switch (flag)						// switch on mode
-			{
-				case 0:
-					WriteData_word(0xffdf);		// write 3 pixels off
-					break;
+			n = (runCnt < x1) ? runCnt : x1;
+			lcd_write_repeat(job->runPixels, n);
+			runCnt -= n;
+			continue;
+		}
 
-				case 1:
-					// check for run of 3 pixels
-					if (runCnt)
-					{
-						--runCnt;
-						WriteData_word(runPixels);		// output 3 run pixels
-						break;
-					}
+		if (!count) image = lcd_job_next(job, &count);
 
-					// check for special code (ccfx)
-					if (*image & 0x0020)
-					{
-						runCnt = *image++;				// get special code
-						switch (runCnt & 0x00ff)		// switch to special case
-						{
-							case 0x00ff:
-								runPixels = 0xffdf;		// 3 pixels off
-								break;
-
-							case 0x00fe:
-								runPixels = 0x0000;		// 3 pixels on
-								break;
-
-							case 0x00f0:
-							default:
-								runPixels = ~*image++;	// run of 3 pixels
-								break;
-						}
-						runCnt >>= 8;					// get run count
-//						++x1;						// setup 1st output
-						x1 += 3;						// setup 1st output
-						break;
-					}
+		// check for special code (ccfx)
+		if (*image & 0x0020)
+		{
+			runCnt = *image++;				// get special code
+			--count;
+			switch (runCnt & 0x00ff)		// switch to special case
+			{
+				case 0x00ff:
+					job->runPixels = 0xffdf;	// 3 pixels off
+					break;
 
-					WriteData_word(~*image++);
+				case 0x00fe:
+					job->runPixels = 0x0000;	// 3 pixels on
 					break;
 
+				case 0x00f0:
 				default:
-				case 2:
-					WriteData_word(0x0000);		// write 3 pixels on (fill)
+					if (!count) image = lcd_job_next(job, &count);
+					job->runPixels = ~*image++;	// run of 3 pixels
+					--count;
 					break;
 			}
+			runCnt >>= 8;					// get run count
+			n = 0;
+			continue;
 		}
-		y--;									// next row
+
+		// output pixel words up to next special code (or end of chunk)
+		for (n = 1; (n < x1) && (n < count) && !(image[n] & 0x0020); ++n);
+		lcd_write_burst_inv(image, n);
+		image += n;
+		count -= n;
 	}
-	return 0;
-} // end lcd_wordImage
+	job->image = image;
+	job->count = count;
+	job->runCnt = runCnt;
+	return;
+} // end lcd_job_row
 
 
 //******************************************************************************
-//	Fill Image
+//	draw job rows for up to us microseconds
 //
-//	IN:		x, y			lower right coordinates
-//			width,height	area to blank
-//			flag = 0		blank image
-//	    		   1		(unused)
-//	    		   2		fill image area
+//	Blank and fill rows are written together in one window the width of
+//	the job; image rows are decoded one at a time.
 //
-//	OUT:	return 0;
+//	IN:		us		time budget (0 = draw all rows)
 //
-uint8 lcd_fill(int16 x, int16 y, uint16 width, uint16 height, uint8 flag)
+//	OUT:	return 1 if more rows to draw, 0 if job done
+//
+uint8 lcd_job_run(LCD_JOB* job, uint16 us)
 {
-	uint16 area[2];
-	area[0] = width;
-	area[1] = height;
-	return lcd_wordImage(area, x, y, flag);
-}
+	uint32 budget = (uint32)us * mclk_kHz / 1000;	// cycles
+	uint32 spent = 0;
+	uint16 cost;
+	int16 rows, n;
+	uint8 col1;
+
+	while (job->top > job->bottom)
+	{
+		if (job->flag == 1)				// image - one row
+		{
+			cost = LCD_JOB_ROW + job->words * LCD_JOB_IMAGE;
+			rows = 1;
+		}
+		else							// blank/fill - all rows that fit
+		{
+			cost = job->words * LCD_JOB_SOLID;
+			rows = job->top - job->bottom;
+			spent += LCD_JOB_ROW;
+		}
+		for (n = 0; n < rows; ++n)
+		{
+			if (us && (spent + cost > budget) && (n || (spent > LCD_JOB_ROW)))
+			{
+				break;					// out of time (at least one row)
+			}
+			spent += cost;
+		}
+		if (n == 0) return 1;			// resume next call
+
+		if (job->flag == 1)
+		{
+			lcd_job_row(job);
+		}
+		else
+		{
+			col1 = job->col + job->words - 1;
+			if (col1 > 0x35) col1 = 0x35;
+			lcd_set_window(job->col, col1, job->top - n + 1, job->top);
+			WriteCmd(0x5c);				// write to memory
+			lcd_write_repeat(job->flag ? 0x0000 : 0xffdf,
+				(col1 - job->col + 1) * n);
+		}
+		job->top -= n;
+	}
+	if (job->clear)						// finish clear
+	{
+		job->clear = 0;
+		lcd_set_done();
+	}
+	return 0;
+} // end lcd_job_run
 
 
 //******************************************************************************
@@ -614,6 +998,134 @@ uint8 lcd_blank(int16 x, int16 y, uint16 width, uint16 height)
 } // end lcd_blank
 
 
+//******************************************************************************
+//	Gray levels
+//
+//	lcd_init loads 16 gray levels per frame (odd frames fields 0,2..30, even
+//	frames 1,3..31).  Gray drawing takes a level 0 (off) - 15 (on), spread
+//	evenly over the 5-bit fields (31 - level * 31 / 15, rounded).
+//
+//	Words are built with table lookups only - lcd_gray_pix[k][level] is the
+//	level in pixel k's field (the rest 0) and lcd_gray_keep[k] keeps the
+//	other two pixels - so a gray point or span costs the same as on/off.
+//
+#define GRAY_F(L)	(31 - ((L) * 31 + 7) / 15)	// level to 5-bit field
+#define GRAY_P0(L)	(GRAY_F(L))
+#define GRAY_P1(L)	(GRAY_F(L) << 6)
+#define GRAY_P2(L)	(GRAY_F(L) << 11)
+#define GRAY_W(L)	(GRAY_P0(L) | GRAY_P1(L) | GRAY_P2(L))
+#define GRAY_16(F)	{ F(0), F(1), F(2), F(3), F(4), F(5), F(6), F(7), \
+	F(8), F(9), F(10), F(11), F(12), F(13), F(14), F(15) }
+
+const uint16 lcd_gray_pix[3][16] = { GRAY_16(GRAY_P0), GRAY_16(GRAY_P1),
+	GRAY_16(GRAY_P2) };
+static const uint16 lcd_gray_word[16] = GRAY_16(GRAY_W);	// all 3 pixels
+static const uint16 lcd_gray_keep[3] = { 0xffc0, 0xf81f, 0x07ff };
+
+
+//******************************************************************************
+//	Invert Image
+//
+//	IN:		x, y			lower left coordinates
+//			width,height	area to invert
+//
+//	OUT:	return 0;
+//
+//	Each row is inverted in read-modify-write mode: one word read and one
+//	word write per 2B3P word (plus the dummy read the controller needs after
+//	a write).  Partial words at the left and right edges are masked.  Gray
+//	levels are inverted too (XOR 0x1f per pixel).
+//
+static const uint16 lcd_rmask[3] = { 0xffdf, 0xffc0, 0xf800 };	// pixel n..2
+static const uint16 lcd_lmask[3] = { 0x001f, 0x07df, 0xffdf };	// pixel 0..n
+
+uint8 lcd_invert(int16 x, int16 y, uint16 width, uint16 height)
+{
+	int16 right, top, row;
+	uint16 col0, col1, first, last, word, mask;
+	uint8 pixel1, pixel2;
+
+	right = x + width - 1;					// clip to screen
+	top = y + height - 1;
+	if (x < 0) x = 0;
+	if (y < 0) y = 0;
+	if (right >= HD_X_MAX) right = HD_X_MAX - 1;
+	if (top >= HD_Y_MAX) top = HD_Y_MAX - 1;
+	if ((x > right) || (y > top)) return 0;
+
+	col0 = 159 - right;						// translate to RAM columns
+	col1 = 159 - x;
+	first = divu3(col0);					// first/last words
+	last = divu3(col1);
+
+	for (row = top; row >= y; --row)
+	{
+		lcd_set_x_y(col0, row);
+		WriteCmd(0xe0);						// RMWIN - read and modify write
+		mask = lcd_rmask[col0 - first - first - first];
+		for (word = first; word <= last; ++word)
+		{
+			if (word == last) mask &= lcd_lmask[col1 - last - last - last];
+			ReadData();						// Dummy read
+			pixel1 = ReadData();
+			pixel2 = ReadData();
+			WriteData(pixel1 ^ (mask >> 8));
+			WriteData(pixel2 ^ mask);
+			mask = 0xffdf;					// inner words - all 3 pixels
+		}
+		WriteCmd(0xee);						// RMWOUT - cancel read modify write
+	}
+	return 0;
+} // end lcd_invert
+
+
+//******************************************************************************
+//	Gray span
+//
+//	IN:		x, y			left end
+//			width			pixels
+//			level			0 (off) - 15 (on)
+//
+//	OUT:	return 0;
+//
+//	Written in read-modify-write mode as lcd_invert (pixel exact - partial
+//	words at the ends keep their other pixels).
+//
+uint8 lcd_span_gray(int16 x, int16 y, uint16 width, uint8 level)
+{
+	int16 right;
+	uint16 col0, col1, first, last, word, mask, gray;
+	uint8 pixel1, pixel2;
+
+	right = x + width - 1;					// clip to screen
+	if (x < 0) x = 0;
+	if (right >= HD_X_MAX) right = HD_X_MAX - 1;
+	if ((x > right) || (y < 0) || (y >= HD_Y_MAX)) return 0;
+
+	col0 = 159 - right;						// translate to RAM columns
+	col1 = 159 - x;
+	first = divu3(col0);					// first/last words
+	last = divu3(col1);
+	gray = lcd_gray_word[level & 0x0f];
+
+	lcd_set_x_y(col0, y);
+	WriteCmd(0xe0);							// RMWIN - read and modify write
+	mask = lcd_rmask[col0 - first - first - first];
+	for (word = first; word <= last; ++word)
+	{
+		if (word == last) mask &= lcd_lmask[col1 - last - last - last];
+		ReadData();							// Dummy read
+		pixel1 = ReadData();
+		pixel2 = ReadData();
+		WriteData((pixel1 & ~(mask >> 8)) | ((gray & mask) >> 8));
+		WriteData((pixel2 & ~mask) | (gray & mask));
+		mask = 0xffdf;						// inner words - all 3 pixels
+	}
+	WriteCmd(0xee);							// RMWOUT - cancel read modify write
+	return 0;
+} // end lcd_span_gray
+
+
 //******************************************************************************
 //	change lcd volume (brightness)
 //
@@ -655,14 +1167,16 @@ void lcd_backlight(uint8 backlight)
 //	             \\\\ \\___ LCD_2X_FONT				2x font
 //	              \\\\ \___ LCD_FRAM_CHARACTER		write to FRAM
 //	               \\\\____ LCD_REVERSE_DISPLAY		reverse display
-//	                \\\____
-//		             \\____
+//	                \\\____ LCD_OR_CHAR				OR characters onto display
+//		             \\____ LCD_SCROLL_TEXT			'\n' scrolls (lcd_scroll)
 //	                  \____
 //
 //	~mode = Turn OFF mode bit(s)
 //
 uint16 lcd_mode(int16 mode)
 {
+	uint16 old_mode = lcd_dmode;
+
 	if (mode)
 	{
 		// set/reset mode bits
@@ -673,10 +1187,91 @@ uint16 lcd_mode(int16 mode)
 	{
 		lcd_dmode = 0;
 	}
+
+	// reverse display is done by the controller (one command)
+	if ((old_mode ^ lcd_dmode) & LCD_REVERSE_DISPLAY)
+	{
+		if (lcd_dmode & LCD_REVERSE_DISPLAY) WriteCmd(0xa7);	// Inverse Display
+		else WriteCmd(0xa6);									// Normal Display
+	}
 	return lcd_dmode;
 } // end lcd_mode
 
 
+//******************************************************************************
+//	read lcd point or set it to level (lcd_point, lcd_point_gray)
+//
+//	IN:		x, y	point (in range)
+//			level	0 (off) - 15 (on), -1 = read point (0 or 1)
+//
+static uint8 lcd_point_level(int16 x, int16 y, int16 level)
+{
+	uint8 pixel1, pixel2;
+	uint16 col, xd3, word;
+	uint8 cached;
+
+	// translate point
+	x = 159 - x;
+//	y = 159 - y;
+	col = divu3(x);
+	xd3 = x - col - col - col;			// x - divu3(x) * 3
+
+	// the last word accessed is cached (window still starts there)
+	cached = lcd_word_valid && (col == lcd_word_col) && (y == lcd_word_line);
+	if (cached)
+	{
+		pixel1 = lcd_word >> 8;
+		pixel2 = lcd_word;
+	}
+	else
+	{
+		lcd_set_window(col, 0x35, y, 0x9f);	// only changed axes are sent
+
+		// read point
+		WriteCmd(0xe0);						// RMWIN - read and modify write
+		ReadData();							// Dummy read
+		pixel1 = ReadData();				// Start read cycle for pixel 2/1
+		pixel2 = ReadData();				// Start read cycle for pixel 1/0
+		if (level < 0) WriteCmd(0xee);		// RMWOUT - read only
+
+		lcd_word = (pixel1 << 8) | pixel2;
+		lcd_word_col = col;
+		lcd_word_line = y;
+		lcd_word_valid = 1;
+	}
+
+	if (level < 0)						// read point
+	{
+		switch (xd3)
+		{
+			case 0:
+				return (pixel2 & 0x1f) ? 1 : 0;
+
+			case 1:
+				return ((pixel1 & 0x07) && (pixel2 & 0xc0)) ? 1 : 0;
+
+			case 2:
+			default:
+				return (pixel1 & 0xf8) ? 1 : 0;
+		}
+	}
+
+	// set point to level (keep the other 2 pixels)
+	word = (((uint16)pixel1 << 8) | pixel2) & lcd_gray_keep[xd3];
+	word |= lcd_gray_pix[xd3][level];
+	if (cached) WriteCmd(0xe0);			// RMWIN - write only (word cached)
+	WriteData(word >> 8);				// Write pixels back
+	WriteData(word);
+	WriteCmd(0xee);						// RMWOUT - back to window start
+
+	lcd_word = word;					// window still starts at this word
+	lcd_word_col = col;
+	lcd_word_line = y;
+	lcd_word_valid = 1;
+	return 0;							// return success
+} // end lcd_point_level
+
+
 //******************************************************************************
 //	access lcd point at x,y
 //
@@ -719,8 +1314,6 @@ uint16 lcd_mode(int16 mode)
 //
 uint8 lcd_point(int16 x, int16 y, int16 flag)
 {
-	uint8 pixel1, pixel2;
-
 	// return 1 if out of range
 	if ((x < 0) || (x >= HD_X_MAX)) return 1;
 	if ((y < 0) || (y >= HD_Y_MAX)) return 1;
@@ -790,82 +1383,26 @@ uint8 lcd_point(int16 x, int16 y, int16 flag)
 		}
 	}
 
-	// translate point
-	x = 159 - x;
-//	y = 159 - y;
-
-	lcd_set_x_y(x, y);					// upper right corner
-
-	// read point
-	WriteCmd(0xe0);						// RMWIN - read and modify write
-	ReadData();							// Dummy read
-	pixel1 = ReadData();				// Start read cycle for pixel 2/1
-	pixel2 = ReadData();				// Start read cycle for pixel 1/0
-
-	{
-		// process point
-		uint16 xd3 = divu3(x);
-		xd3 = x - xd3 - xd3 - xd3;		// x - divu3(x) * 3
-		switch (flag)
-		{
-			case 0:						// turn point off
-				switch (xd3)
-				{
-					case 0:
-						pixel2 |= 0x1f;
-						break;
-
-					case 1:
-						pixel1 |= 0x07;
-						pixel2 |= 0xc0;
-						break;
-
-					case 2:
-					default:
-						pixel1 |= 0xf8;
-				}
-				break;
-
-			case 1:					// turn point on
-				switch (xd3)
-				{
-					case 0:
-						pixel2 &= 0xc0;
-						break;
-
-					case 1:
-						pixel1 &= 0xf8;
-						pixel2 &= 0x1f;
-						break;
-
-					case 2:
-					default:
-						pixel1 &= 0x07;
-				}
-				break;
-
-			default:
-			case 128:					// read point
-			switch (xd3)
-			{
-				case 0:
-					return (pixel2 & 0x1f) ? 1 : 0;
-
-				case 1:
-					return ((pixel1 & 0x07) && (pixel2 & 0xc0)) ? 1 : 0;
+	return lcd_point_level(x, y, (flag == 128) ? -1 : (flag ? 15 : 0));
+} // end lcd_point
 
-				case 2:
-					default:
-					return (pixel1 & 0xf8) ? 1 : 0;
-			}
-		}
-	}
-	WriteData(pixel1);					// Write pixels back
-	WriteData(pixel2);
 
-	WriteCmd(0xee);						// RMWOUT - cancel read modify write mode
-	return 0;							// return success
-} // end lcd_point
+//******************************************************************************
+//	set lcd point at x,y to gray level
+//
+//	IN:		x = column coordinate
+//			y = row coordinate
+//			level	0 (off) - 15 (on)
+//
+//	OUT:	return 0 (1 if out of range)
+//
+uint8 lcd_point_gray(int16 x, int16 y, uint8 level)
+{
+	// return 1 if out of range
+	if ((x < 0) || (x >= HD_X_MAX)) return 1;
+	if ((y < 0) || (y >= HD_Y_MAX)) return 1;
+	return lcd_point_level(x, y, level & 0x0f);
+} // end lcd_point_gray
 
 
 //******************************************************************************
@@ -1262,7 +1799,8 @@ unsigned char lcd_putchar(unsigned char c)
 
 		case '\n':
 		{
-			lcd_y = (lcd_y - CHAR_SIZE * (lcd_dmode & ~LCD_2X_FONT ? 2 : 1)) % HD_Y_MAX;
+			if (lcd_dmode & LCD_SCROLL_TEXT) lcd_newline();
+			else lcd_y = (lcd_y - CHAR_SIZE * (lcd_dmode & ~LCD_2X_FONT ? 2 : 1)) % HD_Y_MAX;
 		}
 
 		case '\r':
@@ -1333,25 +1871,253 @@ unsigned char lcd_putchar(unsigned char c)
 } // end my_putchar
 
 
+//******************************************************************************
+//	formatted output engine
+//
+//	Streams each character to out() as it is generated - there is no print
+//	buffer and no vsprintf.
+//
+//		%[0][width]c	character
+//		%[0][width]s	string
+//		%[0][width]d	signed decimal
+//		%[0][width]u	unsigned decimal
+//		%[0][width]x	hex (%X upper case)
+//		%%				percent
+//
+//	Decimal conversion subtracts powers of ten (no hardware divider).
+//
+static const uint16 lcd_pow10[] = { 10000, 1000, 100, 10 };
+
+static uint8 lcd_utoa(uint16 value, char* digits)
+{
+	const uint16* power = lcd_pow10;
+	char* d_ptr = digits;
+	char digit;
+
+	do
+	{
+		digit = '0';
+		while (value >= *power)
+		{
+			value -= *power;
+			++digit;
+		}
+		if ((digit != '0') || (d_ptr != digits)) *d_ptr++ = digit;
+	} while (++power < lcd_pow10 + 4);
+	*d_ptr++ = '0' + value;					// units
+	return d_ptr - digits;
+} // end lcd_utoa
+
+
+static uint8 lcd_xtoa(uint16 value, char* digits, char upper)
+{
+	char* d_ptr = digits;
+	char digit;
+	int8 i;
+
+	for (i = 4; i > 0; --i)
+	{
+		digit = "0123456789abcdef"[(value >> 12) & 0x0f];
+		value <<= 4;
+		if (upper && (digit > '9')) digit -= 'a' - 'A';
+		if ((digit != '0') || (d_ptr != digits) || (i == 1)) *d_ptr++ = digit;
+	}
+	return d_ptr - digits;
+} // end lcd_xtoa
+
+
+static uint16 lcd_format(unsigned char (*out)(unsigned char),
+	const char* fmt, va_list arg_ptr)
+{
+	char digits[5];
+	const char* s_ptr;
+	char c, fill, sign;
+	int16 width, len, value;
+	uint16 count = 0;
+
+	while ((c = *fmt++))
+	{
+		if (c != '%')
+		{
+			out(c);
+			++count;
+			continue;
+		}
+
+		fill = ' ';							// get flag and width
+		sign = 0;
+		width = 0;
+		if (*fmt == '0')
+		{
+			fill = '0';
+			++fmt;
+		}
+		while ((*fmt >= '0') && (*fmt <= '9'))
+		{
+			width = (width << 3) + (width << 1) + (*fmt++ - '0');
+		}
+
+		s_ptr = digits;
+		switch (c = *fmt++)
+		{
+			case 'c':
+				digits[0] = va_arg(arg_ptr, int);
+				len = 1;
+				break;
+
+			case 's':
+				s_ptr = va_arg(arg_ptr, const char*);
+				len = strlen(s_ptr);
+				break;
+
+			case 'd':
+				value = va_arg(arg_ptr, int);
+				if (value < 0)
+				{
+					sign = '-';
+					len = lcd_utoa(-(uint16)value, digits);	// (-32768 ok)
+				}
+				else len = lcd_utoa(value, digits);
+				break;
+
+			case 'u':
+				len = lcd_utoa(va_arg(arg_ptr, unsigned), digits);
+				break;
+
+			case 'x':
+			case 'X':
+				len = lcd_xtoa(va_arg(arg_ptr, unsigned), digits, c == 'X');
+				break;
+
+			case 0:							// '%' at end of string
+				return count;
+
+			default:
+				digits[0] = c;				// %%
+				len = 1;
+				break;
+		}
+
+		width -= len + (sign ? 1 : 0);		// width = padding
+		if (sign && (fill == '0'))
+		{
+			out(sign);						// sign leads zero fill
+			++count;
+			sign = 0;
+		}
+		for (; width > 0; --width)
+		{
+			out(fill);
+			++count;
+		}
+		if (sign)
+		{
+			out(sign);
+			++count;
+		}
+		for (; len > 0; --len)
+		{
+			out(*s_ptr++);
+			++count;
+		}
+	}
+	return count;
+} // end lcd_format
+
+
 //******************************************************************************
 //	formatted print to lcd
 //
 uint16 lcd_printf(const char* fmt, ...)
 {
-	char printBuffer[PRINT_BUFFER_SIZE+1];
-	char* s_ptr = printBuffer;
-	uint16 s_length = 0;
+	uint16 s_length;
 	va_list arg_ptr;
 
-	if (strlen(fmt) > PRINT_BUFFER_SIZE) ERROR2(SYS_ERR_PRINT);
-
 	va_start(arg_ptr, fmt);					// create pointer to args
-	vsprintf(s_ptr, fmt, arg_ptr);			// generate print string
-	while (*s_ptr)
-	{
-		lcd_putchar(*s_ptr++);				// output string
-		s_length++;
-	}
+	s_length = lcd_format(lcd_putchar, fmt, arg_ptr);
 	va_end(arg_ptr);						// destroy arg pointer
 	return s_length;
 } // end lcd_printf
+
+
+//******************************************************************************
+//	lcd hud fields
+//
+//	A hud field is a fixed run of character cells at x,y that keeps a shadow
+//	of the characters it last drew.  lcd_hud_printf formats into the field
+//	(blank padded to width) and redraws only the cells that changed, so an
+//	unchanged field generates no LCD traffic.  The shadow is dropped when the
+//	screen is cleared (lcd_set) or by lcd_hud_invalidate.
+//
+//	Cells are always 6 columns wide (5x8 font + space); proportional and 2x
+//	modes are ignored and the text cursor is left where it was.
+//
+#define HUD_CELL_WIDTH	6
+
+static HUD_FIELD* hud_field;				// field being printed
+static uint8 hud_cell;						// next cell
+static uint16 hud_count;					// cells redrawn
+
+void lcd_hud_init(HUD_FIELD* field, int16 x, int16 y, uint8 width)
+{
+	field->x = x;
+	field->y = y;
+	field->width = (width < HUD_FIELD_SIZE) ? width : HUD_FIELD_SIZE;
+	lcd_hud_invalidate(field);
+	return;
+} // end lcd_hud_init
+
+
+void lcd_hud_invalidate(HUD_FIELD* field)
+{
+	memset(field->text, 0, HUD_FIELD_SIZE);	// no cell matches shadow
+	field->epoch = lcd_epoch;
+	return;
+} // end lcd_hud_invalidate
+
+
+//	lcd_format output to the next hud cell (lcd_x tracks the cell)
+//
+static unsigned char lcd_hud_putc(unsigned char c)
+{
+	if (hud_cell >= hud_field->width) return c;	// truncate
+	if ((c < ' ') || (c > '~')) c = ' ';	// drop control chars
+	if (hud_field->text[hud_cell] != c)
+	{
+		hud_field->text[hud_cell] = c;
+		lcd_putchar(c);						// advances lcd_x one cell
+		++hud_count;
+	}
+	else lcd_x += HUD_CELL_WIDTH;			// skip unchanged cell
+	++hud_cell;
+	return c;
+} // end lcd_hud_putc
+
+
+//	OUT:	number of cells redrawn
+//
+uint16 lcd_hud_printf(HUD_FIELD* field, const char* fmt, ...)
+{
+	uint16 mode = lcd_dmode;
+	uint8 x = lcd_x;
+	uint8 y = lcd_y;
+	va_list arg_ptr;
+
+	if (field->epoch != lcd_epoch) lcd_hud_invalidate(field);
+	lcd_dmode &= ~(LCD_PROPORTIONAL | LCD_2X_FONT);
+	lcd_x = field->x;
+	lcd_y = field->y;
+	hud_field = field;
+	hud_cell = 0;
+	hud_count = 0;
+
+	va_start(arg_ptr, fmt);					// create pointer to args
+	lcd_format(lcd_hud_putc, fmt, arg_ptr);
+	va_end(arg_ptr);						// destroy arg pointer
+	while (hud_cell < field->width) lcd_hud_putc(' ');	// blank pad
+
+	lcd_dmode = mode;						// restore mode and cursor
+	lcd_x = x;
+	lcd_y = y;
+	return hud_count;
+} // end lcd_hud_printf
@@ -10,9 +10,6 @@
 
 #define CHAR_SIZE			8
 
-//	print buffer size
-#define PRINT_BUFFER_SIZE	32
-
 enum {SINGLE_PEN_OFF, SINGLE_PEN, DOUBLE_PEN_OFF, DOUBLE_PEN};
 #define	READ_POINT		4
 
@@ -28,32 +25,157 @@ uint16 lcd_mode(int16 mode);
 #define LCD_FRAM_CHARACTER	0x08
 #define LCD_REVERSE_DISPLAY	0x10
 #define LCD_OR_CHAR			0x20
+#define LCD_SCROLL_TEXT		0x40
 
 //	lcd prototypes
 uint8 lcd_init(void);
 void lcd_clear(void);
 void lcd_set(uint16 value);
+void lcd_set_lines(uint16 value, int16 line, int16 count);
+void lcd_set_done(void);
 void lcd_backlight(uint8 backlight);
 void lcd_volume(uint16 volume);
+void lcd_scroll(int16 lines);
+uint8 lcd_scroll_line(int16 y);
 
 //	lcd character data
 unsigned char lcd_putchar(unsigned char c);
 uint16 lcd_printf(const char* fmt, ...);
 uint8 lcd_cursor(int16 x, int16 y);
 
+//	lcd hud fields (only changed characters are redrawn)
+#define HUD_FIELD_SIZE		16
+
+typedef struct
+{
+	uint8 x;						// left column
+	uint8 y;						// bottom row
+	uint8 width;					// field width (characters)
+	uint8 epoch;					// lcd_set count when shadow was valid
+	char text[HUD_FIELD_SIZE];		// shadow of last rendered characters
+} HUD_FIELD;
+
+void lcd_hud_init(HUD_FIELD* field, int16 x, int16 y, uint8 width);
+void lcd_hud_invalidate(HUD_FIELD* field);
+uint16 lcd_hud_printf(HUD_FIELD* field, const char* fmt, ...);
+
 uint8 lcd_image(const uint8* image, int16 x, int16 y);
 uint8 lcd_bitImage(const uint8* image, int16 x, int16 y, uint8 flag);
 uint8 lcd_wordImage(const uint16* image, int16 x, int16 y, uint8 flag);
 uint8 lcd_blank(int16 x, int16 y, uint16 width, uint16 height);
 uint8 lcd_fill(int16 x, int16 y, uint16 width, uint16 height, uint8 flag);
+uint8 lcd_invert(int16 x, int16 y, uint16 width, uint16 height);
+
+//	lcd jobs (resumable clear, lcd_wordImage and lcd_fill)
+#define LCD_JOB_US			2000		// main loop stall cap (us)
+
+typedef struct
+{
+	const uint16* image;				// next image word
+	uint16 count;						// 	words left in chunk
+	struct LCD_STREAM* stream;			// 	chunk source (0 = flash image)
+	uint16 runCnt;						// image run count
+	uint16 runPixels;					// 	and run pixels
+	int16 top;							// next row (drawn top down)
+	int16 bottom;						// rows end above bottom
+	uint8 col;							// right LCD word column
+	uint8 words;						// words per row
+	uint8 flag;							// lcd_wordImage flag
+	uint8 clear;						// finish as lcd_clear
+} LCD_JOB;
+
+void lcd_job_clear(LCD_JOB* job);
+void lcd_job_image(LCD_JOB* job, const uint16* image, int16 x, int16 y,
+	uint8 flag);
+void lcd_job_fill(LCD_JOB* job, int16 x, int16 y, uint16 width,
+	uint16 height, uint8 flag);
+uint8 lcd_job_run(LCD_JOB* job, uint16 us);
+
+//	lcd image streams (lcd_stream.c - lcd_wordImage data from flash, FRAM
+//	or UART in small chunks)
+#define LCD_STREAM_WORDS	4			// words per chunk (2 chunks buffered)
+
+typedef struct LCD_STREAM
+{
+	const uint16* (*next)(struct LCD_STREAM* stream, uint16* count);
+	const uint16* flash;				// flash source
+	uint16 addr;						// FRAM source (next byte)
+	uint16 left;						// words not yet fetched
+	uint8 b;							// chunk being fetched
+	uint8 error;						// source failed (SYS_ERR_...)
+	uint16 buf[2][LCD_STREAM_WORDS];	// chunks (FRAM, UART)
+} LCD_STREAM;
+
+void lcd_stream_flash(LCD_STREAM* stream, const uint16* image);
+void lcd_stream_fram(LCD_STREAM* stream, uint16 addr, uint16 bytes);
+void lcd_stream_uart(LCD_STREAM* stream, uint16 bytes);
+uint8 lcd_streamImage(LCD_STREAM* stream, int16 x, int16 y, uint8 flag);
+void lcd_job_stream(LCD_JOB* job, LCD_STREAM* stream, int16 x, int16 y,
+	uint8 flag);
+
+//	lcd packed images (lcd_pack.c - row delta + LZ, tools/lcd_image.py --pack)
+uint8 lcd_packImage(const uint8* image, int16 x, int16 y);
+
+//	lcd gray images (lcd_gray.c - 4 bits per pixel, tools/lcd_image.py --gray)
+uint8 lcd_grayImage(const uint8* image, int16 x, int16 y);
 
 #define lcd_image1	lcd_bitImage
 #define lcd_image2	lcd_wordImage
 
+//	lcd sprites (lcd_sprite.c)
+#define SPRITE_MAX			1			// sprite table (78 bytes each)
+#define SPRITE_BUDGET		300			// bus transactions per frame
+
+#define SPRITE_SET			0			// image pixels on
+#define SPRITE_XOR			1			// image pixels inverted
+
+uint8 lcd_sprite_init(uint8 id, const uint8* image, uint8 mode);
+void lcd_sprite_move(uint8 id, int16 x, int16 y);
+void lcd_sprite_hide(uint8 id);
+uint16 lcd_sprite_update(uint16 budget);
+
+//	lcd command queue (lcd_queue.c - ISRs queue, main loop draws)
+#define LCD_QUEUE_SIZE		4			// commands (power of 2)
+#define LCD_QUEUE_BUDGET	LCD_JOB_US	// us per lcd_queue_run
+
+uint8 lcd_queue_clear(void);
+uint8 lcd_queue_fill(uint8 x, uint8 y, uint8 w, uint8 h, uint8 flag);
+uint8 lcd_queue_text(uint8 x, uint8 y, const char* text);
+uint8 lcd_queue_backlight(uint8 backlight);
+uint8 lcd_queue_run(uint16 us);
+
+//	lcd canvas save/restore (lcd_canvas.c - 1 bit run length compressed)
+#define CANVAS_FRAM_NAME	"canvas"	// FRAM store blob
+#define CANVAS_FRAM_SIZE	4096		// 	bytes (header + compressed)
+
+typedef uint8 (*CANVAS_PUT)(uint8 byte);	// return 1 if full
+typedef int16 (*CANVAS_GET)(void);			// return -1 if no more
+
+uint16 lcd_canvas_save(CANVAS_PUT put);
+uint8 lcd_canvas_restore(CANVAS_GET get);
+uint16 lcd_canvas_store(void);
+uint8 lcd_canvas_load(void);
+
+//	lcd screenshot over UART (lcd_screenshot.c - tools/lcd_screenshot.py)
+#define LCD_SHOT_PGM		0			// 32 gray levels
+#define LCD_SHOT_PBM		1			// 1 bit
+
+void lcd_screenshot(uint8 format);
+
+//	lcd remote display (lcd_remote.c - tools/lcd_remote.py)
+uint8 lcd_remote_task(void);
+
 uint16 lcd_read_word(int16 x, int16 y);
 void lcd_write_word(int16 x, int16 y, uint16 data);
 
+//	lcd bus bursts (RBX430_lcd_bus.asm - after RAMWR)
+void lcd_write_burst(const uint16* src, uint16 count);
+void lcd_write_burst_inv(const uint16* src, uint16 count);
+void lcd_write_repeat(uint16 value, uint16 count);
+
 uint8 lcd_point(int16 x, int16 y, int16 flag);
+uint8 lcd_point_gray(int16 x, int16 y, uint8 level);
+uint8 lcd_span_gray(int16 x, int16 y, uint16 width, uint8 level);
 void lcd_circle(int16 x, int16 y, uint16 radius, uint8 pen);
 void lcd_square(int16 x, int16 y, uint16 side, uint8 pen);
 void lcd_rectangle(int16 x, int16 y, uint16 w, uint16 h, uint8 pen);
@@ -0,0 +1,201 @@
+ 	.title	"RBX430_lcd_bus.asm"
+;*******************************************************************************
+;   MSP430F2274 RBX430_lcd_bus.asm
+;
+;   Description:
+;		Burst data writers for the ST7529 LCD bus (P2 = data, P3.0 = A0,
+;		P3.3 = RW, P4.7 = E).  The bus direction and the A0/RW lines are
+;		set once per call, then each byte is one mov.b to P2OUT and an E
+;		strobe (bis.b/bic.b with E held in a register, so other P4 bits
+;		changed by an ISR are never disturbed).
+;
+;		The controller must already be in RAMWR (0x5c) - these only
+;		write display data, high byte first (same as WriteData_word).
+;
+;		Solid fills (lcd_write_repeat of a word whose two bytes are the
+;		same, ignoring unused bit 5 - 0xffdf all off, 0x0000 all on) leave
+;		the data byte on P2 and only strobe E.
+;
+;		Cycles (MCLK) per LCD word:
+;			WriteData_word called from a C loop	~56
+;			lcd_write_repeat (solid fill)		~16		(16 + loop/8)
+;			lcd_write_repeat					~25		(24 + loop/4)
+;			lcd_write_burst						~30		(29 + loop/2)
+;
+;		10/2026	Initial program (burst writers for LCD data streams)
+;		10/2026	Solid fill path in lcd_write_repeat
+;*******************************************************************************
+		.cdecls	C,LIST,"msp430x22x4.h"
+
+;	external references
+		.def	lcd_write_burst		; write words from memory
+		.def	lcd_write_burst_inv	; write inverted words from memory
+		.def	lcd_write_repeat	; write one word count times
+
+;	LCD control lines (RBX430-1.h)
+LCD_A0	.equ	0x01				; P3.0
+LCD_RW	.equ	0x08				; P3.3
+LCD_E	.equ	0x80				; P4.7
+
+		.text						; Program Section
+;------------------------------------------------------------------------------
+;	MACROS: WRITE ONE LCD WORD (high byte first)
+;
+;	r12 = source pointer (BURST_WORD) / low byte (REPEAT_WORD)
+;	r14 = work / high byte (REPEAT_WORD)
+;	r11 = xor mask (BURST_WORD)
+;	r15 = LCD_E
+;
+BURST_WORD	.macro
+		mov.w	@r12+,r14			; 2 get word
+		xor.w	r11,r14				; 1 (inverted image data)
+		swpb	r14					; 1 high byte
+		mov.b	r14,&P2OUT			; 4
+		bis.b	r15,&P4OUT			; 4 strobe E
+		bic.b	r15,&P4OUT			; 4
+		swpb	r14					; 1 low byte
+		mov.b	r14,&P2OUT			; 4
+		bis.b	r15,&P4OUT			; 4 strobe E
+		bic.b	r15,&P4OUT			; 4
+		.endm
+
+STROBE_E	.macro
+		bis.b	r15,&P4OUT			; 4 strobe E
+		bic.b	r15,&P4OUT			; 4
+		.endm
+
+REPEAT_WORD	.macro
+		mov.b	r14,&P2OUT			; 4 high byte
+		bis.b	r15,&P4OUT			; 4 strobe E
+		bic.b	r15,&P4OUT			; 4
+		mov.b	r12,&P2OUT			; 4 low byte
+		bis.b	r15,&P4OUT			; 4 strobe E
+		bic.b	r15,&P4OUT			; 4
+		.endm
+
+;------------------------------------------------------------------------------
+;	SUBROUTINE: SET LCD BUS FOR DATA WRITE
+;
+;	OUT:	r15 = LCD_E
+;
+lcd_bus_write:
+		mov.b	#0xff,&P2DIR		; output to P2
+		bic.b	#LCD_RW,&P3OUT		; set RW low (write)
+		bis.b	#LCD_A0,&P3OUT		; set A0 high (data)
+		mov.w	#LCD_E,r15
+		ret
+
+;------------------------------------------------------------------------------
+;	SUBROUTINE: WRITE WORDS FROM MEMORY
+;
+;	void lcd_write_burst(const uint16* src, uint16 count)
+;	void lcd_write_burst_inv(const uint16* src, uint16 count)
+;
+;	IN:		r12 = source (flash or RAM)
+;			r13 = number of words
+;
+lcd_write_burst:
+		clr.w	r11					; words as is
+		jmp		burst_01
+
+lcd_write_burst_inv:
+		mov.w	#0xffff,r11			; ~words (lcd_wordImage data)
+
+burst_01:
+		tst.w	r13					; anything to write?
+		  jz	burst_04			; n
+		call	#lcd_bus_write		; y, set bus once
+		clrc
+		rrc.w	r13					; word pairs, odd word?
+		  jnc	burst_02			; n
+		BURST_WORD					; y, write it
+
+burst_02:
+		tst.w	r13					; any pairs?
+		  jz	burst_04			; n
+
+burst_03:
+		BURST_WORD					; 2 words per loop
+		BURST_WORD
+		dec.w	r13
+		  jnz	burst_03
+
+burst_04:
+		ret
+
+;------------------------------------------------------------------------------
+;	SUBROUTINE: WRITE ONE WORD COUNT TIMES
+;
+;	void lcd_write_repeat(uint16 value, uint16 count)
+;
+;	IN:		r12 = LCD word
+;			r13 = number of words
+;
+lcd_write_repeat:
+		tst.w	r13					; anything to write?
+		  jz	repeat_04			; n
+		call	#lcd_bus_write		; y, set bus once
+		mov.w	r12,r14
+		swpb	r14					; r14 = high byte
+		mov.w	r12,r11
+		xor.w	r14,r11
+		and.b	#0xdf,r11			; both bytes the same (but bit 5)?
+		  jz	strobe_01			; y, solid fill
+		mov.w	r13,r11
+		and.w	#3,r11				; count % 4 words first
+		  jz	repeat_02
+
+repeat_01:
+		REPEAT_WORD
+		dec.w	r11
+		  jnz	repeat_01
+
+repeat_02:
+		clrc
+		rrc.w	r13
+		rra.w	r13					; groups of 4 words
+		  jz	repeat_04
+
+repeat_03:
+		REPEAT_WORD					; 4 words per loop
+		REPEAT_WORD
+		REPEAT_WORD
+		REPEAT_WORD
+		dec.w	r13
+		  jnz	repeat_03
+
+repeat_04:
+		ret
+
+;	solid fill - data byte stays on P2, 2 E strobes per word
+;
+strobe_01:
+		mov.b	r14,&P2OUT			; high byte for both bytes
+		mov.w	r13,r11
+		and.w	#7,r11				; count % 8 words first
+		  jz	strobe_03
+
+strobe_02:
+		STROBE_E
+		STROBE_E
+		dec.w	r11
+		  jnz	strobe_02
+
+strobe_03:
+		clrc
+		rrc.w	r13
+		rra.w	r13
+		rra.w	r13					; groups of 8 words
+		  jz	strobe_05
+
+strobe_04:
+		.loop	16					; 8 words per loop
+		STROBE_E
+		.endloop
+		dec.w	r13
+		  jnz	strobe_04
+
+strobe_05:
+		ret
+
+		.end
@@ -0,0 +1,235 @@
+//	RBX430_telemetry.c - framed binary telemetry
+//******************************************************************************
+//******************************************************************************
+//	Description:	Live channel values over the UART (tools/telemetry.py)
+//
+//	Producers (main loop or ISRs) record 16-bit values by channel id with
+//	tm_put (last value) or tm_max (largest since the last frame).  They
+//	only store into a preallocated slot and set a dirty bit - nothing
+//	waits or allocates.  Each channel should have one producer.
+//
+//	tm_task, called from the main loop when it has time, packs the dirty
+//	channels into a frame every TM_PERIOD_MS.  The frame is built and COBS
+//	encoded in place in one static buffer and handed to uart_send (no
+//	copy).  If the UART is still busy (screenshot, last frame) the frame
+//	is skipped and the values ride in the next one.
+//
+//	Frame (before COBS, 16-bit values low byte first):
+//		TM_VERSION, sequence, time (ms), tm_time ticks per ms
+//		channel id, value		(for each dirty channel)
+//		CRC-16/CCITT (0x1021, init 0xffff) of all the above
+//	between 0x00 delimiters (COBS leaves no other zeros) - a receiver
+//	resyncs at the next frame after noise or other UART output.
+//
+//	tm_time is Timer A running continuously from SMCLK/8 (1us @8MHz).
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_uart.h"
+#include "RBX430_telemetry.h"
+
+#define TM_HEADER		6				// version, sequence, time, ticks/ms
+#define TM_RAW_SIZE		(TM_HEADER + TM_CHANNELS * 3 + 2)
+#define TM_FRAME_SIZE	(TM_RAW_SIZE + TM_RAW_SIZE / 254 + 3)	// COBS + 0x00s
+#define TM_RAW_AT		(TM_FRAME_SIZE - TM_RAW_SIZE - 1)	// raw frame offset
+
+extern uint16 mclk_kHz;					// MCLK = SMCLK (kHz)
+
+uint16 tm_ticks_ms;						// tm_time ticks per millisecond
+uint16 tm_lost;							// frames skipped (UART busy)
+
+static int16 tm_value[TM_CHANNELS];		// channel slots
+static volatile uint16 tm_dirty;		// 	changed since last frame
+static uint16 tm_prev;					// tm_task call time
+static uint32 tm_age;					// 	ticks not counted in tm_ms
+static uint16 tm_ms;					// frame time (ms)
+static uint8 tm_seq;					// frame sequence
+static uint8 tm_frame[TM_FRAME_SIZE];	// frame (encoded in place, uart_send)
+
+static const uint16 tm_crc_nib[16] = {	// CRC-16/CCITT by nibble
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+	0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef };
+
+
+//******************************************************************************
+//	Telemetry functions:
+//
+//	void tm_init(void)
+//	uint16 tm_time(void)
+//	void tm_put(uint8 channel, int16 value)
+//	void tm_max(uint8 channel, int16 value)
+//	uint8 tm_task(void)
+//	uint16 tm_crc16(const uint8* data, uint16 count)
+//	uint16 tm_crc_update(uint16 crc, uint8 data)
+//	uint16 tm_cobs(uint8* dst, const uint8* src, uint16 count)
+//
+//******************************************************************************
+//	start telemetry (after RBX430_init and uart_init)
+//
+void tm_init(void)
+{
+	TACTL = TASSEL_2 + ID_3 + MC_2;		// SMCLK/8, continuous
+	tm_ticks_ms = mclk_kHz >> 3;
+	tm_dirty = 0;
+	tm_prev = TAR;
+	tm_age = 0;
+	return;
+} // end tm_init
+
+
+//******************************************************************************
+//	OUT:	return free running time (tm_ticks_ms per millisecond)
+//
+uint16 tm_time(void)
+{
+	return TAR;
+} // end tm_time
+
+
+//******************************************************************************
+//	record channel value (sent in the next frame)
+//
+void tm_put(uint8 channel, int16 value)
+{
+	tm_value[channel] = value;
+	tm_dirty |= 1 << channel;
+	return;
+} // end tm_put
+
+
+//******************************************************************************
+//	record channel value if it is the largest since the last frame
+//
+void tm_max(uint8 channel, int16 value)
+{
+	uint16 bit = 1 << channel;
+
+	if (!(tm_dirty & bit) || (value > tm_value[channel]))
+	{
+		tm_value[channel] = value;
+	}
+	tm_dirty |= bit;
+	return;
+} // end tm_max
+
+
+//******************************************************************************
+//	send frame of dirty channels every TM_PERIOD_MS (call from main loop
+//	at least every 32ms - Timer A wraps every 65536 ticks)
+//
+//	OUT:	return 1 if a frame was sent
+//
+uint8 tm_task(void)
+{
+	uint16 now = TAR;
+	uint16 gie = __get_SR_register() & GIE;
+	uint16 dirty;
+	uint16 crc, ms;
+	uint8* start = tm_frame + TM_RAW_AT;	// raw frame (then COBS)
+	uint8* raw = start;
+	uint8 ch;
+
+	tm_age += (uint16)(now - tm_prev);
+	tm_prev = now;
+	if (tm_age < (uint32)TM_PERIOD_MS * tm_ticks_ms) return 0;
+	ms = tm_age / tm_ticks_ms;			// (once per period)
+	tm_ms += ms;
+	tm_age -= (uint32)ms * tm_ticks_ms;
+	if (!tm_dirty) return 0;
+	if (uart_tx_busy())					// low priority - skip this frame
+	{
+		++tm_lost;
+		return 0;
+	}
+
+	*raw++ = TM_VERSION;
+	*raw++ = tm_seq++;
+	*raw++ = tm_ms & 0xff;
+	*raw++ = tm_ms >> 8;
+	*raw++ = tm_ticks_ms & 0xff;
+	*raw++ = tm_ticks_ms >> 8;
+
+	__bic_SR_register(GIE);				// snapshot with ISRs held off
+	dirty = tm_dirty;
+	tm_dirty = 0;
+	for (ch = 0; dirty; ++ch, dirty >>= 1)
+	{
+		if (!(dirty & 0x01)) continue;
+		*raw++ = ch;
+		*raw++ = tm_value[ch] & 0xff;
+		*raw++ = tm_value[ch] >> 8;
+	}
+	__bis_SR_register(gie);
+
+	crc = tm_crc16(start, raw - start);
+	*raw++ = crc & 0xff;
+	*raw++ = crc >> 8;
+	tm_frame[0] = 0x00;					// leading delimiter
+	uart_send(tm_frame, tm_cobs(tm_frame + 1, start, raw - start) + 1);
+	return 1;
+} // end tm_task
+
+
+//******************************************************************************
+//	CRC-16/CCITT (poly 0x1021, init 0xffff - "CCITT-FALSE")
+//
+uint16 tm_crc16(const uint8* data, uint16 count)
+{
+	uint16 crc = 0xffff;
+
+	while (count--) crc = tm_crc_update(crc, *data++);
+	return crc;
+} // end tm_crc16
+
+
+//******************************************************************************
+//	add byte to CRC-16/CCITT (start with 0xffff)
+//
+uint16 tm_crc_update(uint16 crc, uint8 data)
+{
+	crc ^= (uint16)data << 8;
+	crc = (crc << 4) ^ tm_crc_nib[(crc >> 12) & 0x0f];
+	crc = (crc << 4) ^ tm_crc_nib[(crc >> 12) & 0x0f];
+	return crc;
+} // end tm_crc_update
+
+
+//******************************************************************************
+//	COBS encode src to dst and append 0x00 delimiter
+//
+//	dst needs count + count/254 + 2 bytes.  src may be in the same buffer
+//	at dst + 1 + count/254 or later (encoded in place).
+//
+//	OUT:	return encoded size (with delimiter)
+//
+uint16 tm_cobs(uint8* dst, const uint8* src, uint16 count)
+{
+	uint8* code = dst;					// where the run length goes
+	uint8* out = dst + 1;
+	uint8 run = 1;
+
+	while (count--)
+	{
+		if (*src)
+		{
+			*out++ = *src;
+			if (++run == 0xff)			// longest run - start another
+			{
+				*code = run;
+				code = out++;
+				run = 1;
+			}
+		}
+		else
+		{
+			*code = run;				// zero ends run
+			code = out++;
+			run = 1;
+		}
+		++src;
+	}
+	*code = run;
+	*out++ = 0x00;						// delimiter
+	return out - dst;
+} // end tm_cobs
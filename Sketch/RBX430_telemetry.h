@@ -0,0 +1,25 @@
+//******************************************************************************
+//	Telemetry (framed binary channels over UART - RBX430_telemetry.c)
+//******************************************************************************
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#define TM_CHANNELS			16			// channel ids 0-15
+#define TM_PERIOD_MS		50			// frame period (20 frames/second)
+#define TM_VERSION			1			// frame type
+
+//	telemetry prototypes
+void tm_init(void);
+uint16 tm_time(void);
+void tm_put(uint8 channel, int16 value);
+void tm_max(uint8 channel, int16 value);
+uint8 tm_task(void);
+
+uint16 tm_crc16(const uint8* data, uint16 count);
+uint16 tm_crc_update(uint16 crc, uint8 data);
+uint16 tm_cobs(uint8* dst, const uint8* src, uint16 count);
+
+extern uint16 tm_ticks_ms;				// tm_time ticks per millisecond
+extern uint16 tm_lost;					// frames skipped (UART busy)
+
+#endif /*TELEMETRY_H_*/
@@ -0,0 +1,323 @@
+//	RBX430_uart.c - USCI_A0 UART driver
+//******************************************************************************
+//******************************************************************************
+//	Description:	Interrupt driven UART for the RBX430-1 board
+//
+//	Transmit:	uart_putc bytes are copied into a UART_TX_SIZE ring.
+//				uart_send queues a pointer to constant or static data
+//				(up to UART_SEND_SIZE blocks) - it is sent from where it
+//				is, never copied, and must not change until sent.  The
+//				USCI_A0 TX interrupt sends bytes and blocks in the order
+//				they were queued, so the caller only waits when a queue
+//				is full and the transfer runs at the baud rate.
+//
+//	Receive:	the USCI_A0 RX interrupt puts bytes in a UART_RX_SIZE
+//				ring (UART_RX_SIZE - 1 bytes can wait - one slot tells
+//				full from empty); uart_getc takes them out.  Bytes that
+//				arrive with the ring full are dropped and counted
+//				(uart_rx_lost).
+//
+//	Each ring is lock free - the main loop writes the head and the ISR the
+//	tail (transmit) or the other way around (receive).  A queued block
+//	remembers the TX ring head when it was queued (mark); the TX ISR sends
+//	ring bytes up to the mark, then the block.
+//
+//	The UART is clocked by SMCLK (= MCLK, set by RBX430_init).  Baud rate
+//	divider N = fSMCLK / baud uses the low frequency mode: UCBR = N and
+//	the fraction in eighths goes to the UCBRS modulator.
+//
+//	The USCIAB0 vectors are shared with the I2C master (RBX430_i2c.c) -
+//	the ISRs here pass USCI_B0 interrupts to it.
+//
+//	P3.4 is also LED_5 (green) - LED_GREEN_... has no effect once the UART
+//	owns the pin.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_uart.h"
+#include "RBX430_i2c.h"
+
+#define UART_TX_MASK	(UART_TX_SIZE - 1)
+#define UART_RX_MASK	(UART_RX_SIZE - 1)
+#define UART_SEND_MASK	(UART_SEND_SIZE - 1)
+
+extern uint16 mclk_kHz;					// MCLK = SMCLK (kHz)
+
+typedef struct
+{
+	const uint8* data;					// block to send
+	uint16 count;
+	uint8 mark;							// 	after TX ring bytes up to mark
+} UART_BLOCK;
+
+static uint8 uart_tx[UART_TX_SIZE];		// transmit ring
+static volatile uint8 uart_tx_head;		// next free byte (uart_putc)
+static volatile uint8 uart_tx_tail;		// next byte to send (TX ISR)
+
+static UART_BLOCK uart_send_q[UART_SEND_SIZE];	// zero copy blocks
+static volatile uint8 uart_send_head;	// next free block (uart_send)
+static volatile uint8 uart_send_tail;	// next block to send (TX ISR)
+static const uint8* uart_block;			// block being sent (TX ISR)
+static uint16 uart_block_cnt;
+
+static uint8 uart_rx[UART_RX_SIZE];		// receive ring
+static volatile uint8 uart_rx_head;		// next free byte (RX ISR)
+static volatile uint8 uart_rx_tail;		// next byte to read (uart_getc)
+volatile uint16 uart_rx_lost;			// bytes dropped (ring full)
+
+static const uint32 uart_bauds[] = { 230400, 115200, 57600, 38400, 19200,
+	9600, 0 };
+
+
+//******************************************************************************
+//	UART functions:
+//
+//	uint32 uart_init(uint32 baud)
+//	void uart_putc(uint8 c)
+//	void uart_puts(const char* s)
+//	void uart_write(const uint8* data, uint16 count)
+//	void uart_send(const void* data, uint16 count)
+//	uint8 uart_tx_busy(void)
+//	int16 uart_getc(void)
+//	uint8 uart_rx_count(void)
+//
+//******************************************************************************
+//	initialize USCI_A0 UART (8N1, call after RBX430_init)
+//
+//	IN:		baud	bits/second (0 = fastest standard rate with at least
+//					UART_MIN_DIV SMCLK clocks per bit - 9600 @1MHz,
+//					115200 @8/12MHz, 230400 @16MHz)
+//
+//	OUT:	return baud rate
+//
+uint32 uart_init(uint32 baud)
+{
+	uint32 clock = (uint32)mclk_kHz * 1000;
+	uint16 n8;
+	const uint32* rate;
+
+	if (baud == 0)
+	{
+		for (rate = uart_bauds; rate[1] && (clock / *rate < UART_MIN_DIV);
+			++rate);
+		baud = *rate;
+	}
+	n8 = (clock * 8 + baud / 2) / baud;	// divider in eighths
+
+	UCA0CTL1 = UCSSEL_2 + UCSWRST;		// SMCLK, hold in reset
+	UCA0CTL0 = 0;						// 8N1, LSB first
+	UCA0BR0 = (n8 >> 3) & 0xff;			// UCBR
+	UCA0BR1 = n8 >> 11;
+	UCA0MCTL = (n8 & 0x07) << 1;		// UCBRS (no oversampling)
+	P3SEL |= 0x30;						// P3.4 TXD, P3.5 RXD
+	uart_tx_head = uart_tx_tail = 0;
+	uart_send_head = uart_send_tail = 0;
+	uart_block_cnt = 0;
+	uart_rx_head = uart_rx_tail = 0;
+	uart_rx_lost = 0;
+	UCA0CTL1 &= ~UCSWRST;				// release USCI
+	IE2 |= UCA0RXIE;					// receive interrupts
+	return baud;
+} // end uart_init
+
+
+//******************************************************************************
+//	queue byte (waits while ring is full - interrupts must be enabled)
+//
+void uart_putc(uint8 c)
+{
+	uint8 head = uart_tx_head;
+	uint8 next = (head + 1) & UART_TX_MASK;
+
+	while (next == uart_tx_tail);		// full - TX ISR makes room
+	uart_tx[head] = c;
+	uart_tx_head = next;				// now visible to TX ISR
+	IE2 |= UCA0TXIE;					// (TXIFG set if idle - sends now)
+	return;
+} // end uart_putc
+
+
+//******************************************************************************
+//	queue string
+//
+void uart_puts(const char* s)
+{
+	while (*s) uart_putc(*s++);
+	return;
+} // end uart_puts
+
+
+//******************************************************************************
+//	queue count bytes (copied)
+//
+void uart_write(const uint8* data, uint16 count)
+{
+	while (count--) uart_putc(*data++);
+	return;
+} // end uart_write
+
+
+//******************************************************************************
+//	queue block without copying (waits while UART_SEND_SIZE blocks queued)
+//
+//	IN:		data	constant or static data - must not change until sent
+//					(uart_tx_busy == 0)
+//			count	bytes
+//
+void uart_send(const void* data, uint16 count)
+{
+	uint8 head = uart_send_head;
+	uint8 next = (head + 1) & UART_SEND_MASK;
+	UART_BLOCK* block = &uart_send_q[head];
+
+	if (count == 0) return;
+	while (next == uart_send_tail);		// full - TX ISR makes room
+	block->data = (const uint8*)data;
+	block->count = count;
+	block->mark = uart_tx_head;			// after bytes already queued
+	uart_send_head = next;				// now visible to TX ISR
+	IE2 |= UCA0TXIE;
+	return;
+} // end uart_send
+
+
+//******************************************************************************
+//	OUT:	return 1 if bytes or blocks still queued or shifting out
+//
+uint8 uart_tx_busy(void)
+{
+	return (uart_tx_head != uart_tx_tail) || (uart_send_head != uart_send_tail)
+		|| uart_block_cnt || (UCA0STAT & UCBUSY);
+} // end uart_tx_busy
+
+
+//******************************************************************************
+//	get received byte
+//
+//	OUT:	return byte (-1 if none)
+//
+int16 uart_getc(void)
+{
+	uint8 tail = uart_rx_tail;
+	uint8 c;
+
+	if (tail == uart_rx_head) return -1;
+	c = uart_rx[tail];
+	uart_rx_tail = (tail + 1) & UART_RX_MASK;	// free byte for RX ISR
+	return c;
+} // end uart_getc
+
+
+//******************************************************************************
+//	OUT:	return number of received bytes waiting
+//
+uint8 uart_rx_count(void)
+{
+	return (uart_rx_head - uart_rx_tail) & UART_RX_MASK;
+} // end uart_rx_count
+
+
+//******************************************************************************
+//	USCI_A0 transmit
+//
+//	Order: current block, next block when the TX ring is at its mark,
+//	TX ring byte.  Interrupt is disabled when nothing is left.
+//
+static void uart_tx_isr(void)
+{
+	uint8 tail = uart_tx_tail;
+	UART_BLOCK* block;
+
+	if (!uart_block_cnt && (uart_send_tail != uart_send_head))
+	{
+		block = &uart_send_q[uart_send_tail];
+		if (tail == block->mark)		// ring bytes before it sent?
+		{
+			uart_block = block->data;	// start block
+			uart_block_cnt = block->count;
+			uart_send_tail = (uart_send_tail + 1) & UART_SEND_MASK;
+		}
+	}
+	if (uart_block_cnt)
+	{
+		UCA0TXBUF = *uart_block++;		// (clears UCA0TXIFG)
+		--uart_block_cnt;
+		return;
+	}
+	if (tail != uart_tx_head)
+	{
+		UCA0TXBUF = uart_tx[tail];
+		uart_tx_tail = tail = (tail + 1) & UART_TX_MASK;
+	}
+	if ((tail == uart_tx_head) && (uart_send_tail == uart_send_head))
+	{
+		IE2 &= ~UCA0TXIE;				// all sent
+	}
+	return;
+} // end uart_tx_isr
+
+
+//******************************************************************************
+//	USCI_A0 receive
+//
+static void uart_rx_isr(void)
+{
+	uint8 head = uart_rx_head;
+	uint8 next = (head + 1) & UART_RX_MASK;
+	uint8 c;
+
+	c = UCA0RXBUF;						// (clears UCA0RXIFG)
+	if (next == uart_rx_tail)
+	{
+		++uart_rx_lost;					// ring full - drop
+		return;
+	}
+	uart_rx[head] = c;
+	uart_rx_head = next;				// now visible to uart_getc
+	return;
+} // end uart_rx_isr
+
+
+//******************************************************************************
+//	USCI_A0/B0 transmit interrupt service routine
+//
+//	Shared by the UART transmitter and the USCI_B0 I2C data interrupts
+//	(I2C receive data also comes here).  Only enabled flags are served.
+//
+#pragma vector = USCIAB0TX_VECTOR
+__interrupt void USCIAB0TX_ISR(void)
+{
+	uint8 ifg = IFG2 & IE2;
+
+	if (ifg & (UCB0TXIFG + UCB0RXIFG))	// I2C data
+	{
+		if (i2c_data_isr()) __bic_SR_register_on_exit(CPUOFF);
+	}
+	if (ifg & UCA0TXIFG) uart_tx_isr();
+	return;
+} // end USCIAB0TX_ISR
+
+
+//******************************************************************************
+//	USCI_A0/B0 receive interrupt service routine
+//
+//	Shared by the UART receiver and the USCI_B0 I2C state interrupts (no
+//	acknowledge).  Anything else is a system error.
+//
+#pragma vector = USCIAB0RX_VECTOR
+__interrupt void USCIAB0RX_ISR(void)
+{
+	if (IFG2 & UCA0RXIFG)
+	{
+		uart_rx_isr();
+		return;
+	}
+	if (UCB0STAT & UCNACKIFG)			// I2C no acknowledge
+	{
+		if (i2c_state_isr()) __bic_SR_register_on_exit(CPUOFF);
+		return;
+	}
+	ERROR2(SYS_ERR_USCB_RX);			// not the UART or I2C
+	return;
+} // end USCIAB0RX_ISR
@@ -0,0 +1,24 @@
+//******************************************************************************
+//	UART (USCI_A0 - P3.4 TXD, P3.5 RXD)
+//******************************************************************************
+#ifndef UART_H_
+#define UART_H_
+
+#define UART_TX_SIZE		32			// transmit ring (power of 2)
+#define UART_RX_SIZE		32			// receive ring (power of 2)
+#define UART_SEND_SIZE		4			// queued uart_send blocks (power of 2)
+#define UART_MIN_DIV		64			// BRCLK clocks per bit (error < ~1%)
+
+//	uart prototypes
+uint32 uart_init(uint32 baud);
+void uart_putc(uint8 c);
+void uart_puts(const char* s);
+void uart_write(const uint8* data, uint16 count);
+void uart_send(const void* data, uint16 count);
+uint8 uart_tx_busy(void);
+int16 uart_getc(void);
+uint8 uart_rx_count(void);
+
+extern volatile uint16 uart_rx_lost;	// bytes dropped (receive ring full)
+
+#endif /*UART_H_*/
@@ -9,6 +9,21 @@
 //	the LCD and another to toggle the size of the drawing pen. Display
 //	the pen coordinates in the lower right corner of the display."
 //
+//	Telemetry (tools/telemetry.py): pot samples, filtered pot values,
+//	main loop time, lcd_printf time, WDT tick jitter and accelerometer
+//	magnitude (TM_... channels in etch-a-sketch.h).
+//
+//	Switches:	SW1 = clear, SW2 = pen size, SW3 = undo last stroke,
+//				SW4 = replay drawing, SW3+SW4 = save drawing to FRAM,
+//				SW1+SW2 = restore saved drawing,
+//				SW2+SW3 = screenshot to UART (tools/lcd_screenshot.py),
+//				SW1+SW4 = tilt steering on/off (accelerometer draws)
+//
+//	Shake the board to clear the drawing (ADXL345 - motion.c).
+//
+//	Remote display (tools/lcd_remote.py): the PC can clear, fill, blit
+//	and print on the display between pen updates.
+//
 //   Author:	Paul Roper, Brigham Young University
 //				November 2012
 //
@@ -19,6 +34,11 @@
 #include <stdlib.h>
 #include "RBX430-1.h"
 #include "RBX430_lcd.h"
+#include "RBX430_uart.h"
+#include "RBX430_telemetry.h"
+#include "RBX430_i2c.h"
+#include "RBX430_adxl345.h"
+#include "RBX430_fram.h"
 #include "etch-a-sketch.h"
 #include <math.h>
 
@@ -36,21 +56,39 @@
 
 #define LCDDELAY		1300
 #define DEBOUNCE_CNT	20
+#define STROKE_IDLE		(WDT_CPS/2)		// pen rest ending a stroke (~1/2 sec)
+#define STATUS_TIME		(WDT_CPS*2)		// status message shown (~2 sec)
+#define SW_SAVE			0x10			// SW3 + SW4 event
+#define SW_RESTORE		0x20			// SW1 + SW2 event
+#define SW_SHOT			0x40			// SW2 + SW3 event
+#define SW_TILT			0x80			// SW1 + SW4 event
+#define WDT_TICKS		(32768/8)		// tm_time ticks per WDT interval
 
 int thickness = 1;
 int THRESHOLD = 3;
 int WDT_debounce_cnt = 0;
 int switches = 0;
 int LCDdelay = 32000;
+volatile int sw_events = 0;				// switches for main loop
+volatile int WDT_stroke_cnt = 0;		// stroke idle countdown
+volatile int WDT_status_cnt = 0;		// status message countdown
+uint8 accel = 0;						// ADXL345 running
+uint8 tilt = 0;							// tilt steers pen
 
 
 volatile int WDT_cps_cnt;				// WD counts/second
 
+HUD_FIELD coordinates;					// pen coordinates (lower right)
+
+#define CURSOR	0						// cursor sprite id
+const uint8 cursor_image[] = { 5, 5,	// crosshair (center open)
+	0x20, 0x20, 0xd8, 0x20, 0x20 };
+
 extern const uint16 byu1_image[];				// BYU logo
 extern const uint16 etch_a_sketch_image[];		// etch-a-sketch image
 extern const uint16 etch_a_sketch1_image[];		// etch-a-sketch writing
 
-void drawline (int x0, int y0, int x1, int y1)
+void plotline(int x0, int y0, int x1, int y1, int pen)
 {
 	int dy = abs(y1 - y0);
 	int dx = abs(x1 - x0);
@@ -62,7 +100,7 @@ void drawline (int x0, int y0, int x1, int y1)
 
 	for(;;)
 	{
-		lcd_point(x0, y0, thickness);
+		lcd_point(x0, y0, pen);
 
 		if(x0 == x1 && y0 == y1)
 		{
@@ -84,6 +122,15 @@ void drawline (int x0, int y0, int x1, int y1)
 		}
 
 	}
+	return;
+}
+
+
+void drawline (int x0, int y0, int x1, int y1)
+{
+	stroke_add(x0, y0, x1, y1, thickness);		// log for undo/replay
+	plotline(x0, y0, x1, y1, thickness);
+	WDT_stroke_cnt = STROKE_IDLE;
 	lcd_backlight(ON);
 	LCDdelay = LCDDELAY;
 	return;
@@ -101,6 +148,8 @@ void main(void)
 	ERROR2(RBX430_init(_8MHZ));					// init RBX430 board
 	ERROR2(lcd_init());							// init lcd
 	ERROR2(ADC_init());							// init a/d converter
+	uart_init(0);								// screenshots (115200 baud)
+	tm_init();									// telemetry
 
 	// configure Watchdog
 	WDT_cps_cnt = WDT_CPS;						// set WD 1 second counter
@@ -108,6 +157,9 @@ void main(void)
 	IE1 |= WDTIE;								// enable WDT interrupt
 
 	__bis_SR_register(GIE);						// enable interrupts
+	i2c_init(0);								// i2c (I2C_FSCL)
+	accel = (xl_init(XL_RATE_100HZ) == 0);		// shake/tilt (if answering)
+	fram_init();								// canvas store (if answering)
 
 	// update display (interrupts enabled)
 	lcd_clear();								// clear LCD
@@ -120,37 +172,160 @@ void main(void)
 
 	int x0 = 0;
 	int y0 = 0;
+	int xc = -1;								// cursor position
+	int yc = -1;
+	uint16 loop_time = tm_time();
+	uint16 t;
+	XL_SAMPLE sample;
+	int xt = 0;									// tilt pen position
+	int yt = 0;
+
+	lcd_hud_init(&coordinates, 110, 0, 8);	// "159,159" + blank
+	lcd_sprite_init(CURSOR, cursor_image, SPRITE_XOR);
 
 	while (1)
 	{
+		t = tm_time();
+		tm_put(TM_LOOP, t - loop_time);			// main loop time
+		loop_time = t;
+		tm_task();								// telemetry frame due?
+		if (uart_rx_count())					// PC frame arriving -
+		{
+			lcd_sprite_hide(CURSOR);			// 	keep cursor out of its pixels
+		}
+		if (lcd_remote_task())					// PC drew on display
+		{
+			lcd_hud_invalidate(&coordinates);
+		}
+
+		// draw commands queued by ISRs (skip pen while screen clears)
+		if (lcd_queue_run(LCD_QUEUE_BUDGET)) continue;
 
 		int i;
+		int adc;
 		int x = 0;
 		for(i=0; i<N_SAMPLES; i++)
 		{
-			x += 1023 - ADC_read(LEFT_POT);
+			adc = ADC_read(LEFT_POT);
+			x += 1023 - adc;
 		}
+		tm_put(TM_LEFT_POT, adc);
 		x += 1 << (N_SHIFT-1);
 		x >>= N_SHIFT;
+		tm_put(TM_LEFT_AVG, x);
 		int x1 = scale(x);
 
 		int y = 0;
 		for(i=0; i<N_SAMPLES; i++)
 		{
-			y += 1023 - ADC_read(RIGHT_POT);
+			adc = ADC_read(RIGHT_POT);
+			y += 1023 - adc;
 		}
+		tm_put(TM_RIGHT_POT, adc);
 		y += 1 << (N_SHIFT-1);
 		y >>= N_SHIFT;
+		tm_put(TM_RIGHT_AVG, y);
 		int y1 = scale(y);
 
+		if (sw_events)							// switch actions
+		{
+			int events = sw_events;
+			sw_events &= ~events;
+
+			if (events & 0x01)					// screen clear (queued by ISR)
+			{
+				stroke_clear();
+			}
+			if (events & 0x02)					// pen size
+			{
+				thickness = (thickness == 1) ? 3 : 1;
+				stroke_end();
+			}
+			if (events & 0x04)					// undo last stroke
+			{
+				lcd_sprite_hide(CURSOR);
+				stroke_undo();
+				lcd_hud_invalidate(&coordinates);
+			}
+			if (events & 0x08)					// replay drawing
+			{
+				lcd_clear();
+				stroke_replay();
+			}
+			if (events & SW_SAVE)				// save canvas to FRAM
+			{
+				lcd_sprite_hide(CURSOR);
+				if (lcd_canvas_store() == 0)	// no FRAM or store full
+				{
+					lcd_hud_printf(&coordinates, "save err");
+					WDT_status_cnt = STATUS_TIME;
+				}
+			}
+			if (events & SW_RESTORE)			// restore saved canvas
+			{
+				lcd_sprite_hide(CURSOR);
+				if (lcd_canvas_load() == 0) stroke_clear();	// log is stale
+				else
+				{
+					lcd_hud_printf(&coordinates, "load err");
+					WDT_status_cnt = STATUS_TIME;
+				}
+			}
+			if (events & SW_SHOT)				// screenshot (as shown)
+			{
+				lcd_screenshot(LCD_SHOT_PGM);
+			}
+			if ((events & SW_TILT) && accel)	// tilt steering on/off
+			{
+				tilt = !tilt;
+				xt = x1;						// from the pot position
+				yt = y1;
+				motion_tilt_start(xt, yt);
+				stroke_end();
+			}
+		}
+		if (WDT_stroke_cnt == 0) stroke_end();	// pen rested
+
+		// accelerometer samples (a FIFO watermark batch at a time)
+		while (accel && xl_read(&sample))
+		{
+			tm_max(TM_ACCEL_MAG, motion_magnitude(&sample));
+			if (motion_shake(&sample))			// shaken - clear
+			{
+				__bic_SR_register(GIE);			// (WDT_ISR queues too)
+				lcd_queue_clear();
+				__bis_SR_register(GIE);
+				stroke_clear();
+				LCDdelay = LCDDELAY;
+			}
+			if (tilt) motion_tilt(&sample, &xt, &yt);
+		}
+
+		if (tilt)								// accelerometer steers
+		{
+			x1 = xt;
+			y1 = yt;
+		}
+
 		if(x0 == 0 || y0 == 0)
 		{
 			x0 = x1;
 			y0 = y1;
 		}
 
-		lcd_cursor(110, 0);						// output coordinates
-		lcd_printf("%d,%d   ", x1, y1);
+		if(x1 != xc || y1 != yc)				// pen moved
+		{
+			lcd_sprite_hide(CURSOR);			// keep lines out of save-under
+			xc = x1;
+			yc = y1;
+		}
+
+		if (!WDT_status_cnt)					// (status message shown)
+		{
+			t = tm_time();
+			lcd_hud_printf(&coordinates, "%d,%d", x1, y1);	// changed digits only
+			tm_max(TM_PRINTF, tm_time() - t);
+		}
 
 		if(abs(x1-x0) > THRESHOLD || abs(y1-y0) > THRESHOLD)
 		{
@@ -159,7 +334,8 @@ void main(void)
 			y0 = y1;
 		}
 
-
+		lcd_sprite_move(CURSOR, x1 - 2, y1 - 2);	// centered on pen
+		lcd_sprite_update(SPRITE_BUDGET);
 
 	}
 } // end main
@@ -168,6 +344,8 @@ void main(void)
 #pragma vector = PORT1_VECTOR
 __interrupt void Port_1_ISR(void)
 {
+	if (P1IFG & ADXL345_INT) xl_port1_isr();	// accelerometer FIFO
+	if (!(P1IFG & 0x0f)) return;
 	LCDdelay = LCDDELAY;
 	P1IFG &= ~0x0f;						// P1.0-3 IFG cleared
 	WDT_debounce_cnt = DEBOUNCE_CNT;	// enable debounce
@@ -179,36 +357,38 @@ __interrupt void Port_1_ISR(void)
 #pragma vector = WDT_VECTOR
 __interrupt void WDT_ISR(void)
 {
+	static uint8 backlight = ON;
+	static uint16 tick_time;
+	static int16 ticks;
+	uint16 t = tm_time();
+
+	if (ticks) tm_max(TM_WDT_JITTER, abs((int16)(t - tick_time - WDT_TICKS)));
+	tm_put(TM_WDT_COUNT, ++ticks);
+	tick_time = t;
+
+	// ISRs never draw - LCD changes are queued for the main loop
 	LCDdelay--;
-	if(LCDdelay <= 0)
+	if(((LCDdelay > 0) != backlight) && !lcd_queue_backlight(!backlight))
 	{
-		lcd_backlight(OFF);
-	}
-	else
-	{
-		lcd_backlight(ON);
+		backlight = !backlight;				// (queue full - retry next tick)
 	}
 // Check for switch debounce
 
 	if(WDT_debounce_cnt && (--WDT_debounce_cnt == 0))
 	{
 		switches = (P1IN ^ 0x0f) & 0x0f;
+		if(switches == 0x0c) switches = SW_SAVE;
+		if(switches == 0x03) switches = SW_RESTORE;
+		if(switches == 0x06) switches = SW_SHOT;
+		if(switches == 0x09) switches = SW_TILT;
 		if(switches == 1)
 		{
-			lcd_clear();
-		}
-		if(switches == 2)
-		{
-			if(thickness == 1)
-			{
-				thickness = 3;
-			}
-			else
-			{
-				thickness = 1;
-			}
+			lcd_queue_clear();
 		}
+		sw_events |= switches;					// handled in main loop
 	}
+	if (WDT_stroke_cnt) --WDT_stroke_cnt;
+	if (WDT_status_cnt) --WDT_status_cnt;
 
 	if (--WDT_cps_cnt == 0)						// 1 second?
 	{
@@ -10,5 +10,35 @@
 
 #define ScaleX(x) ((x)*(1023.0/159.0))
 
+//	stroke log (stroke_log.c)
+#define STROKE_LOG_SIZE	128				// bytes of RAM (~100 segments)
+
+void stroke_clear(void);
+void stroke_add(int x0, int y0, int x1, int y1, int pen);
+void stroke_end(void);
+uint8 stroke_undo(void);
+void stroke_replay(void);
+
+void plotline(int x0, int y0, int x1, int y1, int pen);
+
+//	accelerometer gestures (motion.c - samples from RBX430_adxl345.c)
+#include "RBX430_adxl345.h"
+
+uint16 motion_magnitude(const XL_SAMPLE* sample);
+uint8 motion_shake(const XL_SAMPLE* sample);
+void motion_tilt_start(int x, int y);
+void motion_tilt(const XL_SAMPLE* sample, int* x, int* y);
+
+//	telemetry channels (RBX430_telemetry.c - tools/telemetry.py)
+#define TM_LEFT_POT		0				// last ADC_read sample
+#define TM_RIGHT_POT	1
+#define TM_LEFT_AVG		2				// filtered (0-1023)
+#define TM_RIGHT_AVG	3
+#define TM_LOOP			4				// main loop time (tm_time ticks)
+#define TM_PRINTF		5				// lcd_hud_printf time (max)
+#define TM_WDT_JITTER	6				// WDT interval error (max, ticks)
+#define TM_WDT_COUNT	7				// WDT interrupts
+#define TM_ACCEL_MAG	8				// accelerometer magnitude (max, g*256)
+
 
 #endif /* ETCH_A_SKETCH_H_ */
@@ -0,0 +1,352 @@
+//	lcd_canvas.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Canvas save/restore for YM160160C/ST7529 LCD
+//
+//	The whole display RAM (160 lines of 54 LCD words, 3 pixels per word) is
+//	read back with RAMRD, reduced to 1 bit per pixel (on = darker than half
+//	gray) and run length compressed on the fly - nothing but the current
+//	run is buffered.  Restore decodes the runs back into LCD words and
+//	writes them with lcd_write_repeat (long runs) and lcd_write_burst.
+//
+//	Compressed format (pixels in RAM order: line 0-159, word 0-53, high
+//	pixel first - 25920 pixels including the 2 unused pixels per line):
+//		runs of off, on, off, on... pixels (the first run may be 0)
+//		each run is 3 bits per nibble, low bits first, 0x8 = more nibbles
+//		nibbles are packed high nibble first (last byte padded with 0)
+//
+//	Most runs in a line drawing are short, so nibbles take 25-45% fewer
+//	bytes than a byte per run (test/test_canvas.cpp).  A blank screen is 3
+//	bytes; a sketch of 60 strokes ~1.3K, the splash screen 1388 bytes.
+//
+//	The compressed bytes go to a put function and come back from a get
+//	function, so any store can be used.  The FRAM store (lcd_canvas_store
+//	and lcd_canvas_load) keeps one canvas in the CANVAS_FRAM_NAME blob
+//	(CANVAS_FRAM_SIZE bytes, created on the first store - fram_init formats
+//	a new part).  Bytes are staged in a CANVAS_CHUNK byte buffer, one I2C
+//	transaction per chunk.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+#include "RBX430_fram.h"
+
+#define CANVAS_PIXELS	(HD_Y_MAX * 54 * 3)		// pixels in display RAM
+#define CANVAS_WORDS	9				// restore burst buffer (LCD words)
+#define CANVAS_MAGIC	0xc5			// FRAM store valid
+#define CANVAS_HEADER	3				// magic + compressed size
+#define CANVAS_CHUNK	16				// FRAM bytes per transaction
+
+void WriteCmd(uint8 c);
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1);
+
+static const uint16 canvas_half[3] = { 0x8000, 0x0400, 0x0010 };	// MSB
+static const uint16 canvas_field[3] = { 0xf800, 0x07c0, 0x001f };	// pixel
+
+static CANVAS_PUT canvas_put;			// compressed byte output
+static uint16 canvas_size;				// 	bytes output
+static uint8 canvas_full;				// 	put failed
+static uint8 canvas_nib;				// high nibble held (0x10 = none)
+
+static CANVAS_GET canvas_get;			// compressed byte input
+static uint16 canvas_buf[CANVAS_WORDS];	// 	restore burst buffer
+static uint8 canvas_n;					// 	words in canvas_buf
+
+static uint8 canvas_chunk[CANVAS_CHUNK];	// FRAM store staging
+static uint16 canvas_addr;				// 	FRAM address of canvas_chunk[0]
+static uint16 canvas_end;				// 	end of blob
+static uint8 canvas_i;					// 	next byte in canvas_chunk
+
+
+//******************************************************************************
+//	output nibble (bytes are put high nibble first)
+//
+static void canvas_putnib(uint8 nib)
+{
+	if (canvas_nib & 0x10)
+	{
+		canvas_nib = nib;				// hold high nibble
+		return;
+	}
+	if (!canvas_full && canvas_put((canvas_nib << 4) | nib)) canvas_full = 1;
+	++canvas_size;
+	canvas_nib = 0x10;
+	return;
+} // end canvas_putnib
+
+
+//******************************************************************************
+//	output run length (3 bits per nibble, low bits first)
+//
+static void canvas_run(uint16 run)
+{
+	while (run > 0x07)
+	{
+		canvas_putnib((run & 0x07) | 0x08);	// more to come
+		run >>= 3;
+	}
+	canvas_putnib(run);
+	return;
+} // end canvas_run
+
+
+//******************************************************************************
+//	input run length
+//
+//	OUT:	return run (-1 if input ended)
+//
+static int16 canvas_getrun(void)
+{
+	uint16 run = 0;
+	uint8 shift = 0;
+	int16 nib;
+
+	do
+	{
+		if (canvas_nib & 0x10)			// next byte
+		{
+			if ((nib = canvas_get()) < 0) return -1;
+			canvas_nib = nib & 0x0f;	// low nibble next
+			nib >>= 4;
+		}
+		else
+		{
+			nib = canvas_nib;
+			canvas_nib = 0x10;
+		}
+		run |= (uint16)(nib & 0x07) << shift;
+		shift += 3;
+	} while ((nib & 0x08) && (shift < 16));
+	return run;
+} // end canvas_getrun
+
+
+//******************************************************************************
+//	write restored LCD word (bursts of CANVAS_WORDS)
+//
+static void canvas_word(uint16 word)
+{
+	canvas_buf[canvas_n++] = word;
+	if (canvas_n == CANVAS_WORDS)
+	{
+		lcd_write_burst(canvas_buf, CANVAS_WORDS);
+		canvas_n = 0;
+	}
+	return;
+} // end canvas_word
+
+
+//******************************************************************************
+//	Canvas functions:
+//
+//	uint16 lcd_canvas_save(CANVAS_PUT put)
+//	uint8 lcd_canvas_restore(CANVAS_GET get)
+//	uint16 lcd_canvas_store(void)
+//	uint8 lcd_canvas_load(void)
+//
+//******************************************************************************
+//	compress display RAM to put
+//
+//	Hide sprites (lcd_sprite_hide) first - XOR images are read as drawn.
+//
+//	IN:		put		called with each compressed byte (return 1 if full)
+//
+//	OUT:	return compressed size (0 if put was full)
+//
+uint16 lcd_canvas_save(CANVAS_PUT put)
+{
+	uint16 run = 0;
+	uint16 word;
+	uint8 on = 0;						// current run color
+	uint8 line, col, k;
+
+	canvas_put = put;
+	canvas_size = 0;
+	canvas_full = 0;
+	canvas_nib = 0x10;
+	for (line = 0; line < HD_Y_MAX; ++line)
+	{
+		for (col = 0; col < 54; ++col)
+		{
+			word = lcd_read_word(col, line);	// sequential RAMRD stream
+			if (!on && ((word & 0x8410) == 0x8410))
+			{
+				run += 3;				// 3 pixels off (most words)
+				continue;
+			}
+			for (k = 0; k < 3; ++k)
+			{
+				if (((word & canvas_half[k]) == 0) != on)
+				{
+					canvas_run(run);	// color change
+					on ^= 1;
+					run = 0;
+				}
+				++run;
+			}
+		}
+	}
+	canvas_run(run);
+	if (!(canvas_nib & 0x10)) canvas_putnib(0);	// pad last byte
+	return canvas_full ? 0 : canvas_size;
+} // end lcd_canvas_save
+
+
+//******************************************************************************
+//	restore display RAM from get
+//
+//	Finishes like lcd_clear (mode, cursor and scroll reset, sprite and hud
+//	shadows invalidated).
+//
+//	IN:		get		return next compressed byte (-1 if none)
+//
+//	OUT:	return 0 (1 if data bad - rest of display blanked)
+//
+uint8 lcd_canvas_restore(CANVAS_GET get)
+{
+	uint16 pixels = CANVAS_PIXELS;
+	uint16 word = 0xffdf;				// pixels off
+	int16 run;
+	uint16 n;
+	uint8 on = 0;
+	uint8 k = 0;						// next pixel in word
+	uint8 bad;
+
+	canvas_get = get;
+	canvas_nib = 0x10;
+	canvas_n = 0;
+	lcd_set_window(0, 0x35, 0, 0x9f);	// whole display RAM
+	WriteCmd(0x5c);						// write to memory
+
+	while (pixels)
+	{
+		run = canvas_getrun();
+		if ((run < 0) || ((uint16)run > pixels)) break;	// bad data
+		pixels -= run;
+		while (run)
+		{
+			if ((k == 0) && (run >= 3))		// whole words
+			{
+				for (n = 0; run >= 3; run -= 3) ++n;
+				if (canvas_n)
+				{
+					lcd_write_burst(canvas_buf, canvas_n);
+					canvas_n = 0;
+				}
+				lcd_write_repeat(on ? 0x0000 : 0xffdf, n);
+				continue;
+			}
+			if (on) word &= ~canvas_field[k];
+			--run;
+			if (++k == 3)
+			{
+				canvas_word(word);
+				word = 0xffdf;
+				k = 0;
+			}
+		}
+		on ^= 1;
+	}
+	bad = (pixels != 0);
+	if (bad && k)						// bad data - finish word
+	{
+		canvas_word(word);
+		pixels -= 3 - k;
+	}
+	lcd_write_burst(canvas_buf, canvas_n);
+	for (n = 0; pixels >= 3; pixels -= 3) ++n;
+	lcd_write_repeat(0xffdf, n);		// blank what is missing
+	lcd_set_done();
+	return bad;
+} // end lcd_canvas_restore
+
+
+//******************************************************************************
+//	FRAM store put/get
+//
+static uint8 canvas_fram_flush(void)
+{
+	if (fram_write(canvas_addr, canvas_chunk, canvas_i)) return 1;
+	canvas_addr += canvas_i;
+	canvas_i = 0;
+	return 0;
+} // end canvas_fram_flush
+
+static uint8 canvas_fram_put(uint8 byte)
+{
+	if (canvas_addr + canvas_i >= canvas_end) return 1;	// full
+	canvas_chunk[canvas_i++] = byte;
+	return (canvas_i == CANVAS_CHUNK) ? canvas_fram_flush() : 0;
+} // end canvas_fram_put
+
+static int16 canvas_fram_get(void)
+{
+	uint16 n;
+
+	if (canvas_i == CANVAS_CHUNK)		// next chunk
+	{
+		if (canvas_addr >= canvas_end) return -1;
+		n = canvas_end - canvas_addr;
+		if (n > CANVAS_CHUNK) n = CANVAS_CHUNK;
+		if (fram_read(canvas_addr, canvas_chunk + CANVAS_CHUNK - n, n)) return -1;
+		canvas_addr += n;
+		canvas_i = CANVAS_CHUNK - n;
+	}
+	return canvas_chunk[canvas_i++];
+} // end canvas_fram_get
+
+
+//******************************************************************************
+//	save canvas to FRAM store
+//
+//	The header is written last - a canvas that did not fit (or a reset
+//	during the save) is never loaded, and the canvas saved before it is
+//	gone.
+//
+//	Times at 8MHz (estimated): display read and compress ~120ms, FRAM
+//	writes ~1ms per 10 bytes at 100kHz (~200ms for a 2K byte canvas).
+//
+//	OUT:	return compressed size (0 if too big for store or no FRAM)
+//
+uint16 lcd_canvas_store(void)
+{
+	uint16 addr = fram_find(CANVAS_FRAM_NAME, 0);
+	uint16 size;
+	uint8 header[CANVAS_HEADER];
+
+	if (!addr) addr = fram_create(CANVAS_FRAM_NAME, CANVAS_FRAM_SIZE);
+	if (!addr) return 0;
+
+	header[0] = 0;						// invalid while saving
+	if (fram_write(addr, header, 1)) return 0;
+	canvas_addr = addr + CANVAS_HEADER;
+	canvas_end = addr + CANVAS_FRAM_SIZE;
+	canvas_i = 0;
+	size = lcd_canvas_save(canvas_fram_put);
+	if (!size || canvas_fram_flush()) return 0;
+
+	header[0] = CANVAS_MAGIC;			// now mark valid
+	header[1] = size & 0xff;
+	header[2] = size >> 8;
+	return fram_write(addr, header, CANVAS_HEADER) ? 0 : size;
+} // end lcd_canvas_store
+
+
+//******************************************************************************
+//	restore canvas from FRAM store
+//
+//	OUT:	return 0 (1 if no canvas stored - display not changed)
+//
+uint8 lcd_canvas_load(void)
+{
+	uint16 addr = fram_find(CANVAS_FRAM_NAME, 0);
+	uint8 header[CANVAS_HEADER];
+
+	if (!addr || fram_read(addr, header, CANVAS_HEADER)) return 1;
+	if (header[0] != CANVAS_MAGIC) return 1;
+	canvas_addr = addr + CANVAS_HEADER;
+	canvas_end = canvas_addr + (header[1] | (header[2] << 8));
+	canvas_i = CANVAS_CHUNK;			// (empty)
+	return lcd_canvas_restore(canvas_fram_get);
+} // end lcd_canvas_load
@@ -0,0 +1,90 @@
+//	lcd_gray.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	4-bpp gray images for YM160160C/ST7529 LCD
+//
+//	A gray image (tools/lcd_image.py --gray, ordered dithered) stores one
+//	gray level (0 = off - 15 = on) per pixel, two pixels per byte:
+//
+//		uint8 width, height, then for each row from the top, the row's LCD
+//		words (right to left, as lcd_wordImage) as 3 levels each, rightmost
+//		pixel first, packed low nibble first (a row with an odd word count
+//		ends with a half used byte)
+//
+//	So two words are 3 bytes, and each word is 3 table lookups ORed
+//	together (lcd_gray_pix - the level already in its pixel's field): no
+//	per-pixel field shifts or masks, only the nibble split.  Decoded words
+//	are written GRAY_WORDS at a time with lcd_write_burst.
+//
+//	A 160 x 160 image is 12960 bytes (lcd_wordImage raw is 17280).
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+#define GRAY_WORDS		8				// LCD words per burst (even)
+
+extern const uint16 lcd_gray_pix[3][16];	// level in pixel 0, 1, 2 field
+
+void WriteCmd(uint8 c);
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1);
+
+
+//******************************************************************************
+//	Gray image functions:
+//
+//	uint8 lcd_grayImage(const uint8* image, int16 x, int16 y)
+//
+//******************************************************************************
+//	output 4-bpp gray image
+//
+//	IN:		image		lcd_grayImage table (tools/lcd_image.py --gray)
+//			x, y		lower left (x as lcd_wordImage)
+//
+//	OUT:	return 0
+//
+uint8 lcd_grayImage(const uint8* image, int16 x, int16 y)
+{
+	uint16 buf[GRAY_WORDS];				// decoded words
+	uint8 width = *image++;				// get width/height
+	uint8 height = *image++;
+	uint8 words = divu3(width + 2);		// 3 pixels per word (round up)
+	uint8 col, j, n, b0, b1, b2;
+	int16 top;
+
+	x += width - 1;						// move to top, left (make 0 based)
+	col = divu3(159 - x);				// upper right corner
+
+	for (top = y + height; top > y; --top)	// display from top down
+	{
+		lcd_set_window(col, 0x35, top, 0x9f);
+		WriteCmd(0x5c);					// write to memory
+
+		n = 0;
+		for (j = words; j > 1; j -= 2)	// 2 words from 3 bytes
+		{
+			b0 = *image++;
+			b1 = *image++;
+			b2 = *image++;
+			buf[n++] = lcd_gray_pix[0][b0 & 0x0f] | lcd_gray_pix[1][b0 >> 4] |
+				lcd_gray_pix[2][b1 & 0x0f];
+			buf[n++] = lcd_gray_pix[0][b1 >> 4] | lcd_gray_pix[1][b2 & 0x0f] |
+				lcd_gray_pix[2][b2 >> 4];
+			if (n == GRAY_WORDS)
+			{
+				lcd_write_burst(buf, n);
+				n = 0;
+			}
+		}
+		if (j)							// odd word (2 bytes)
+		{
+			b0 = *image++;
+			b1 = *image++;
+			buf[n++] = lcd_gray_pix[0][b0 & 0x0f] | lcd_gray_pix[1][b0 >> 4] |
+				lcd_gray_pix[2][b1 & 0x0f];
+		}
+		if (n) lcd_write_burst(buf, n);
+	}
+	return 0;
+} // end lcd_grayImage
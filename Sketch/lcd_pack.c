@@ -0,0 +1,118 @@
+//	lcd_pack.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Packed (row delta + LZ) images for YM160160C/ST7529 LCD
+//
+//	lcd_wordImage only compresses runs of identical words, so textured or
+//	dithered art barely shrinks.  A packed image (tools/lcd_image.py --pack)
+//	codes each row against the row above and against itself:
+//
+//		uint8 width, height, then for each row from the top, tokens that
+//		rebuild the row's LCD words (right to left, as lcd_wordImage):
+//
+//		00nnnnnn w...	n+1 literal words (low byte first)
+//		01nnnnnn		n+1 words unchanged from the row above
+//		10nnnnnn oo		n+1 words copied from offset oo (int8) - behind is
+//						this row, ahead is still the row above
+//		11nnnnnn		n+1 copies of the word before
+//
+//	The decoder keeps one row of history (PACK_WORDS words, 108 bytes on
+//	the stack): as a row is rebuilt in place, words behind the current one
+//	are the new row and words ahead are the row above, so a copy can reach
+//	either.  Each token's words go from the row buffer straight to the LCD
+//	with one lcd_write_burst (lcd_write_repeat for a repeat); an unchanged
+//	run costs nothing but the burst.
+//
+//	On the BYU and Etch-a-Sketch images packed tables are 13-45% smaller
+//	than the lcd_wordImage tables and draw the same pixels (test/test_pack.cpp);
+//	they decode in ~1.15-1.45x the time (estimated cycles, see
+//	tools/lcd_image.py).
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+#define PACK_WORDS		54				// LCD words per line
+
+#define PACK_LITERAL	0				// token types (bits 7-6)
+#define PACK_ABOVE		1
+#define PACK_COPY		2
+#define PACK_REPEAT		3
+
+void WriteCmd(uint8 c);
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1);
+
+
+//******************************************************************************
+//	Packed image functions:
+//
+//	uint8 lcd_packImage(const uint8* image, int16 x, int16 y)
+//
+//******************************************************************************
+//	output packed image
+//
+//	IN:		image		lcd_packImage table (tools/lcd_image.py --pack)
+//			x, y		lower left (x as lcd_wordImage)
+//
+//	OUT:	return 0
+//
+uint8 lcd_packImage(const uint8* image, int16 x, int16 y)
+{
+	uint16 row[PACK_WORDS];				// row being rebuilt (row above)
+	uint8 width = *image++;				// get width/height
+	uint8 height = *image++;
+	uint8 words = divu3(width + 2);		// 3 pixels per 2 bytes (round up)
+	uint8 col, j, n, code;
+	uint16* dst;
+	const uint16* src;
+	int16 top;
+
+	x += width - 1;						// move to top, left (make 0 based)
+	col = divu3(159 - x);				// upper right corner
+	for (j = 0; j < words; ++j) row[j] = 0xffdf;	// above image - off
+
+	for (top = y + height; top > y; --top)	// display from top down
+	{
+		lcd_set_window(col, 0x35, top, 0x9f);
+		WriteCmd(0x5c);					// write to memory
+
+		for (j = 0; j < words; j += n)	// display from right to left
+		{
+			code = *image++;
+			n = (code & 0x3f) + 1;
+			dst = &row[j];
+			switch (code >> 6)
+			{
+				case PACK_LITERAL:
+				{
+					for (code = n; code; --code)
+					{
+						*dst++ = image[0] | (image[1] << 8);
+						image += 2;
+					}
+					break;
+				}
+
+				case PACK_ABOVE:		// (already in row)
+					break;
+
+				case PACK_COPY:
+				{
+					src = dst + (int8)*image++;
+					for (code = n; code; --code) *dst++ = *src++;
+					break;
+				}
+
+				case PACK_REPEAT:
+				{
+					lcd_write_repeat(dst[-1], n);
+					for (code = n; code; --code, ++dst) *dst = dst[-1];
+					continue;
+				}
+			}
+			lcd_write_burst(&row[j], n);
+		}
+	}
+	return 0;
+} // end lcd_packImage
@@ -0,0 +1,173 @@
+//	lcd_queue.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Deferred LCD command queue for YM160160C/ST7529 LCD
+//
+//	A whole screen clear is 8640 LCD words - far too long for an interrupt
+//	service routine (every other interrupt waits while it runs).  Instead,
+//	ISRs queue drawing commands (clear, fill, text, backlight) in a small
+//	ring and the main loop draws them with lcd_queue_run, a budget of
+//	microseconds at a time.  Clears and fills are run as LCD jobs (see
+//	lcd_job_run), so no single call blocks for a whole screen operation.
+//
+//	The ring is lock free for one producer and one consumer: only the
+//	producer writes lcd_q_head and only lcd_queue_run writes lcd_q_tail.
+//	MSP430 ISRs do not nest, so all ISRs together are one producer.  The
+//	main loop should draw directly, not queue (or queue with interrupts
+//	disabled).
+//
+//	Text pointers are stored, not copied - queue constant strings only.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+#define LCD_Q_CLEAR			1			// commands
+#define LCD_Q_FILL			2
+#define LCD_Q_TEXT			3
+#define LCD_Q_BACKLIGHT		4
+
+#define LCD_Q_MASK			(LCD_QUEUE_SIZE - 1)
+#define LCD_Q_CHAR_US		70			// ~us per character (8MHz)
+
+typedef struct
+{
+	uint8 command;
+	uint8 arg;							// fill flag / backlight
+	uint8 x, y;							// lower left
+	uint8 w, h;							// size
+	const char* text;
+} LCD_CMD;
+
+static LCD_CMD lcd_q[LCD_QUEUE_SIZE];
+static volatile uint8 lcd_q_head;		// next free entry (producer)
+static volatile uint8 lcd_q_tail;		// oldest entry (lcd_queue_run)
+static LCD_JOB lcd_q_job;				// clear/fill being drawn
+static uint8 lcd_q_job_on;				// 	lcd_q_job is oldest entry
+
+
+//******************************************************************************
+//	add command to queue (entry is published last)
+//
+//	OUT:	return 0 (1 if queue full - command dropped)
+//
+static uint8 lcd_queue_put(uint8 command, uint8 arg, uint8 x, uint8 y,
+	uint8 w, uint8 h, const char* text)
+{
+	uint8 head = lcd_q_head;
+	LCD_CMD* cmd = &lcd_q[head];
+
+	head = (head + 1) & LCD_Q_MASK;
+	if (head == lcd_q_tail) return 1;	// full
+	cmd->command = command;
+	cmd->arg = arg;
+	cmd->x = x;
+	cmd->y = y;
+	cmd->w = w;
+	cmd->h = h;
+	cmd->text = text;
+	lcd_q_head = head;					// now visible to lcd_queue_run
+	return 0;
+} // end lcd_queue_put
+
+
+//******************************************************************************
+//	Queue functions (call from ISRs):
+//
+//	uint8 lcd_queue_clear(void)
+//	uint8 lcd_queue_fill(uint8 x, uint8 y, uint8 w, uint8 h, uint8 flag)
+//	uint8 lcd_queue_text(uint8 x, uint8 y, const char* text)
+//	uint8 lcd_queue_backlight(uint8 backlight)
+//
+//	OUT:	return 0 (1 if queue full - command dropped)
+//
+//******************************************************************************
+//	queue lcd_clear
+//
+uint8 lcd_queue_clear(void)
+{
+	return lcd_queue_put(LCD_Q_CLEAR, 0, 0, 0, 0, 0, 0);
+} // end lcd_queue_clear
+
+
+//******************************************************************************
+//	queue lcd_fill (same arguments)
+//
+uint8 lcd_queue_fill(uint8 x, uint8 y, uint8 w, uint8 h, uint8 flag)
+{
+	return lcd_queue_put(LCD_Q_FILL, flag, x, y, w, h, 0);
+} // end lcd_queue_fill
+
+
+//******************************************************************************
+//	queue text at x,y (text must stay valid until drawn)
+//
+uint8 lcd_queue_text(uint8 x, uint8 y, const char* text)
+{
+	return lcd_queue_put(LCD_Q_TEXT, 0, x, y, 0, 0, text);
+} // end lcd_queue_text
+
+
+//******************************************************************************
+//	queue lcd_backlight (kept in order with drawing)
+//
+uint8 lcd_queue_backlight(uint8 backlight)
+{
+	return lcd_queue_put(LCD_Q_BACKLIGHT, backlight, 0, 0, 0, 0, 0);
+} // end lcd_queue_backlight
+
+
+//******************************************************************************
+//	draw queued commands (main loop)
+//
+//	A clear or fill is set up as an LCD job and given the rest of the
+//	budget; lcd_queue_run returns after each job slice, and the job
+//	resumes on the next call.  A clear finishes like lcd_clear (mode,
+//	cursor and scroll reset, sprite and hud shadows invalidated).  Text
+//	is charged an estimated LCD_Q_CHAR_US per character.
+//
+//	IN:		us			time budget (LCD_QUEUE_BUDGET)
+//
+//	OUT:	number of commands still queued (0 = display up to date)
+//
+uint8 lcd_queue_run(uint16 us)
+{
+	LCD_CMD* cmd;
+	uint16 used = 0;
+
+	while ((lcd_q_tail != lcd_q_head) && (used < us))
+	{
+		cmd = &lcd_q[lcd_q_tail];
+		switch (cmd->command)
+		{
+			case LCD_Q_CLEAR:
+			case LCD_Q_FILL:
+				if (!lcd_q_job_on)
+				{
+					if (cmd->command == LCD_Q_CLEAR) lcd_job_clear(&lcd_q_job);
+					else lcd_job_fill(&lcd_q_job, cmd->x, cmd->y, cmd->w, cmd->h,
+						cmd->arg);
+					lcd_q_job_on = 1;
+				}
+				lcd_q_job_on = lcd_job_run(&lcd_q_job, us - used);
+				used = us;						// (one job slice per call)
+				break;
+
+			case LCD_Q_TEXT:
+				lcd_cursor(cmd->x, cmd->y);
+				used += lcd_printf("%s", cmd->text) * LCD_Q_CHAR_US;
+				break;
+
+			case LCD_Q_BACKLIGHT:
+				lcd_backlight(cmd->arg);
+				break;
+
+			default:
+				break;
+		}
+		if (lcd_q_job_on) break;				// resume next call
+		lcd_q_tail = (lcd_q_tail + 1) & LCD_Q_MASK;	// free entry
+	}
+	return (lcd_q_head - lcd_q_tail) & LCD_Q_MASK;
+} // end lcd_queue_run
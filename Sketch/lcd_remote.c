@@ -0,0 +1,279 @@
+//	lcd_remote.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Remote display - drive the LCD from a PC over the UART
+//
+//	The PC (tools/lcd_remote.py) sends COBS frames between 0x00
+//	delimiters (same framing as telemetry):
+//		command, sequence, arguments, CRC-16/CCITT (low byte first)
+//
+//		RD_CLEAR						lcd_clear
+//		RD_FILL		x, y, w, h, on		lcd_fill (x,y = lower left)
+//		RD_BLIT		col, line, words, lines, 2B3P words (high byte first)
+//										LCD RAM words col.. by lines line..
+//										(RAM line, not scrolled row)
+//		RD_TEXT		x, y, characters	lcd_printf at x,y (lower left)
+//
+//	and waits for the reply frame before sending the next one:
+//		status (RD_ACK or RD_ERR_...), sequence, CRC-16
+//
+//	Frames are decoded a byte at a time straight from the UART receive
+//	ring - blit words go to WriteData_word as they arrive, nothing is
+//	staged.  The last two bytes of a frame are the CRC, so decoded bytes
+//	are held back two bytes before they are used.  A blit is drawn before
+//	its CRC is checked; on RD_ERR_CRC the PC sends the frame again.  Other
+//	commands run only when the CRC is good.
+//
+//	Once a frame starts, lcd_remote_task stays with it until it ends, so
+//	the receive ring never fills and a large blit runs at the baud rate
+//	(~15us of CPU per 87us byte at 8MHz/115200).  The rest of the main
+//	loop waits meanwhile.
+//
+//	Only RD_BLIT moves lcd_epoch - hide sprites before calling while a
+//	frame is arriving, or a clear, fill or text under one is undone when
+//	the sprite puts back the words it saved.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+#include "RBX430_uart.h"
+#include "RBX430_telemetry.h"
+
+#define RD_CLEAR		1				// commands
+#define RD_FILL			2
+#define RD_BLIT			3
+#define RD_TEXT			4
+
+#define RD_ACK			0x80			// reply status
+#define RD_ERR_CRC		0x81			// 	CRC bad - send again
+#define RD_ERR_CMD		0x82			// 	unknown command or bad arguments
+#define RD_ERR_LOST		0x83			// 	bytes lost (overrun or timeout)
+
+#define RD_TEXT_SIZE	27				// characters (160 / 6)
+#define RD_TIMEOUT_MS	250				// no byte this long - frame lost
+
+extern uint8 lcd_epoch;					// lcd_set count
+
+void WriteCmd(uint8 c);
+void WriteData_word(uint16 data);
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1);
+
+static const uint8 rd_args[] = { 0, 0, 5, 4, 2 };	// argument bytes
+
+static uint8 rd_frame;					// frame in progress
+static uint8 rd_left;					// COBS bytes left in block
+static uint8 rd_zero;					// 	block ends with 0x00
+static uint8 rd_held[2];				// last 2 decoded bytes (CRC?)
+static uint8 rd_nheld;
+static uint16 rd_lost;					// uart_rx_lost at frame start
+
+static uint16 rd_count;					// bytes parsed
+static uint16 rd_crc;
+static uint8 rd_status;
+static uint8 rd_cmd;
+static uint8 rd_seq;
+static uint8 rd_arg[5];
+static uint16 rd_payload;				// blit bytes to go
+static uint8 rd_hi;						// 	high byte of word
+static char rd_text[RD_TEXT_SIZE + 1];
+static uint8 rd_len;
+
+
+//******************************************************************************
+//	parse frame byte (CRC not included)
+//
+static void rd_byte(uint8 c)
+{
+	uint16 n = rd_count++;
+
+	rd_crc = tm_crc_update(rd_crc, c);
+	if (n == 0)
+	{
+		rd_cmd = c;
+		if ((c < RD_CLEAR) || (c > RD_TEXT)) rd_status = RD_ERR_CMD;
+		return;
+	}
+	if (n == 1)
+	{
+		rd_seq = c;
+		return;
+	}
+	if (rd_status != RD_ACK) return;	// skip rest
+
+	n -= 2;
+	if (n < rd_args[rd_cmd])			// arguments
+	{
+		rd_arg[n] = c;
+		if ((rd_cmd == RD_BLIT) && (n == 3))
+		{
+			if (!rd_arg[2] || !rd_arg[3] || (rd_arg[0] + rd_arg[2] > 54)
+				|| (rd_arg[1] + rd_arg[3] > HD_Y_MAX))
+			{
+				rd_status = RD_ERR_CMD;
+				return;
+			}
+			lcd_set_window(rd_arg[0], rd_arg[0] + rd_arg[2] - 1,
+				rd_arg[1], rd_arg[1] + rd_arg[3] - 1);
+			WriteCmd(0x5c);				// write to memory
+			rd_payload = (uint16)rd_arg[2] * rd_arg[3] * 2;
+			++lcd_epoch;				// sprite/hud shadows may be stale
+		}
+		return;
+	}
+	if ((rd_cmd == RD_BLIT) && rd_payload)
+	{
+		if (--rd_payload & 0x01) rd_hi = c;	// high byte first
+		else WriteData_word(((uint16)rd_hi << 8) | c);
+		return;
+	}
+	if ((rd_cmd == RD_TEXT) && (rd_len < RD_TEXT_SIZE))
+	{
+		rd_text[rd_len++] = c;
+		return;
+	}
+	rd_status = RD_ERR_CMD;				// too long
+	return;
+} // end rd_byte
+
+
+//******************************************************************************
+//	frame done - run command and reply
+//
+static void rd_end(void)
+{
+	uint8 reply[4];
+	uint8 frame[7];
+	uint16 crc;
+
+	if (!rd_count && !rd_nheld) return;	// empty (back to back 0x00s)
+	if (uart_rx_lost != rd_lost) rd_status = RD_ERR_LOST;
+	if (rd_status == RD_ACK)
+	{
+		if ((rd_nheld < 2) || (rd_crc != (uint16)(rd_held[0] | (rd_held[1] << 8))))
+		{
+			rd_status = RD_ERR_CRC;
+		}
+		else if ((rd_count < (uint16)(2 + rd_args[rd_cmd])) || rd_payload)
+		{
+			rd_status = RD_ERR_CMD;		// short
+		}
+	}
+	if (rd_status == RD_ACK)
+	{
+		switch (rd_cmd)
+		{
+			case RD_CLEAR:
+				lcd_clear();
+				break;
+
+			case RD_FILL:
+				lcd_fill(rd_arg[0], rd_arg[1], rd_arg[2], rd_arg[3],
+					rd_arg[4] ? 2 : 0);
+				break;
+
+			case RD_TEXT:
+				rd_text[rd_len] = 0;
+				lcd_cursor(rd_arg[0], rd_arg[1]);
+				lcd_printf("%s", rd_text);
+				break;
+		}
+	}
+
+	reply[0] = rd_status;
+	reply[1] = (rd_count > 1) ? rd_seq : 0;
+	crc = tm_crc16(reply, 2);
+	reply[2] = crc & 0xff;
+	reply[3] = crc >> 8;
+	frame[0] = 0x00;					// leading delimiter
+	uart_write(frame, tm_cobs(frame + 1, reply, 4) + 1);
+	return;
+} // end rd_end
+
+
+//******************************************************************************
+//	COBS decode received byte
+//
+static void rd_input(uint8 c)
+{
+	if (c == 0x00)						// delimiter - frame end
+	{
+		if (rd_frame) rd_end();
+		rd_frame = 0;
+		return;
+	}
+	if (!rd_frame)						// frame start
+	{
+		rd_frame = 1;
+		rd_left = 0;
+		rd_zero = 0;
+		rd_nheld = 0;
+		rd_count = 0;
+		rd_crc = 0xffff;
+		rd_status = RD_ACK;
+		rd_payload = 0;
+		rd_len = 0;
+		rd_lost = uart_rx_lost;
+	}
+	if (rd_left == 0)					// code byte
+	{
+		rd_left = c - 1;
+		if (rd_zero) c = 0;				// previous block ended in 0x00
+		rd_zero = (rd_left != 0xfe);
+		if (!c) goto decoded;
+		return;
+	}
+	--rd_left;
+
+decoded:
+	if (rd_nheld < 2)					// hold back last 2 bytes
+	{
+		rd_held[rd_nheld++] = c;
+		return;
+	}
+	rd_byte(rd_held[0]);
+	rd_held[0] = rd_held[1];
+	rd_held[1] = c;
+	return;
+} // end rd_input
+
+
+//******************************************************************************
+//	process remote display frames (call from main loop)
+//
+//	Returns at once if no frame is arriving; otherwise stays until the
+//	frame ends (or no byte comes for RD_TIMEOUT_MS - RD_ERR_LOST).  The
+//	timeout is counted on tm_time (Timer A, started by tm_init), so it
+//	does not depend on MCLK or on how fast this loop spins.
+//
+//	OUT:	return 1 if a frame was handled
+//
+uint8 lcd_remote_task(void)
+{
+	uint16 start = tm_time();			// last byte (or ms boundary)
+	uint16 idle = 0;					// ms without a byte
+	uint8 done = 0;
+	int16 c;
+
+	while (1)
+	{
+		if ((c = uart_getc()) < 0)
+		{
+			if (!rd_frame) return done;
+			if ((uint16)(tm_time() - start) < tm_ticks_ms) continue;
+			start += tm_ticks_ms;
+			if (++idle >= RD_TIMEOUT_MS)	// gave up waiting
+			{
+				rd_status = RD_ERR_LOST;
+				rd_end();
+				rd_frame = 0;
+				return 1;
+			}
+			continue;
+		}
+		start = tm_time();
+		idle = 0;
+		if (!c && rd_frame) done = 1;
+		rd_input(c);
+	}
+} // end lcd_remote_task
@@ -0,0 +1,73 @@
+//	lcd_screenshot.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Screenshot of YM160160C/ST7529 LCD over UART
+//
+//	Streams what the panel shows (scroll and reverse display applied) as a
+//	binary PGM (P5, 32 gray levels - the 5 bit 2B3P pixel value) or 1-bit
+//	PBM (P4) image, top row first.  Pixels are unpacked a few LCD words at
+//	a time and queued in the UART transmit ring; the UART TX interrupt
+//	sends while the next words are read, so the transfer time is set by
+//	the baud rate (PGM 25.6K bytes ~2.3s, PBM 3.2K bytes ~0.3s at 115200).
+//
+//	Display column x is RAM column 159 - x, so a row is read right to left
+//	in runs of LCD_SHOT_WORDS sequential RAMRD words (x = 0 is RAM word
+//	53, pixel 0; words 53 pixels 1-2 are not displayed).
+//
+//	Receive with tools/lcd_screenshot.py.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+#include "RBX430_uart.h"
+
+#define LCD_SHOT_WORDS	9				// words read per run (54 = 6 x 9)
+
+static const uint8 lcd_shot_shift[3] = { 0, 6, 11 };	// pixel 0, 1, 2
+
+
+//******************************************************************************
+//	send screenshot over UART (uart_init first)
+//
+//	IN:		format	LCD_SHOT_PGM or LCD_SHOT_PBM
+//
+//	Returns when the last byte is queued (uart_tx_busy while sending).
+//
+void lcd_screenshot(uint8 format)
+{
+	uint16 words[LCD_SHOT_WORDS];
+	uint8 reverse = (lcd_mode(~0) & LCD_REVERSE_DISPLAY) ? 0x1f : 0;
+	uint8 bits = 0;						// PBM byte
+	uint8 x = 0;
+	uint8 gray, line, w, k;
+	int16 y, col;
+
+	uart_puts((format == LCD_SHOT_PBM) ? "P4\n160 160\n" : "P5\n160 160\n31\n");
+	for (y = HD_Y_MAX - 1; y >= 0; --y)	// top row first
+	{
+		line = lcd_scroll_line(y);
+		for (col = 54 - LCD_SHOT_WORDS; col >= 0; col -= LCD_SHOT_WORDS)
+		{
+			for (w = 0; w < LCD_SHOT_WORDS; ++w)
+			{
+				words[w] = lcd_read_word(col + w, line);
+			}
+			for (w = LCD_SHOT_WORDS; w-- > 0; )	// right to left
+			{
+				for (k = 3; k-- > 0; )
+				{
+					if ((col + w == 53) && k) continue;	// not displayed
+					gray = ((words[w] >> lcd_shot_shift[k]) & 0x1f) ^ reverse;
+					if (format == LCD_SHOT_PBM)
+					{
+						bits = (bits << 1) | (gray < 0x10);	// 1 = black
+						if ((++x & 0x07) == 0) uart_putc(bits);
+					}
+					else uart_putc(gray);
+				}
+			}
+		}
+	}
+	return;
+} // end lcd_screenshot
@@ -0,0 +1,277 @@
+//	lcd_sprite.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Sprites with save-under buffers for YM160160C/ST7529 LCD
+//
+//	A sprite is a 1-bit image (lcd_bitImage format, up to 8x8) drawn over
+//	the display.  The display words under the sprite are saved with one
+//	RAMRD block read before it is drawn and written back to erase it, so
+//	moving a sprite only touches the words of its old and new bounding
+//	boxes - the canvas under it is never redrawn.
+//
+//	Moves are deferred: lcd_sprite_move records the new position and
+//	lcd_sprite_update redraws moved sprites, stopping when the frame's
+//	budget of bus transactions is used up (at least one sprite is always
+//	redrawn, so every sprite eventually catches up).
+//
+//	Sprites should not overlap each other.  Anything drawn under a visible
+//	sprite is lost when it moves - hide it first (lcd_sprite_hide).
+//******************************************************************************
+//
+#include <string.h>
+
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+extern uint8 lcd_epoch;					// lcd_set count
+
+void WriteCmd(uint8 c);
+int ReadData(void);
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1);
+
+#define SPRITE_ROW_WORDS	4			// 8 pixels span at most 4 words
+
+//	sprite flags
+#define SPRITE_USED		0x01			// table entry in use
+#define SPRITE_DRAWN	0x02			// on display (save[] valid)
+#define SPRITE_SHOW		0x04			// should be on display
+#define SPRITE_MOVED	0x08			// redraw pending
+
+typedef struct
+{
+	const uint8* image;					// width, height, rows (msb = left)
+	int16 x, y;							// requested lower left
+	uint8 flags;
+	uint8 mode;							// SPRITE_SET or SPRITE_XOR
+	uint8 epoch;						// lcd_epoch when drawn
+	uint8 first;						// drawn area: first word column
+	uint8 words;						//	words per row
+	uint8 line;							//	first (bottom) line
+	uint8 lines;						//	number of lines
+	uint16 save[SPRITE_ROW_WORDS * 8];	// display words under sprite
+} SPRITE;
+
+static SPRITE lcd_sprites[SPRITE_MAX];
+static uint8 lcd_sprite_next;			// round robin update start
+
+static const uint16 lcd_pixel_bits[3] = { 0x001f, 0x07c0, 0xf800 };
+
+
+//******************************************************************************
+//	set controller window to a sprite area
+//
+static void lcd_sprite_window(SPRITE* sprite)
+{
+	lcd_set_window(sprite->first, sprite->first + sprite->words - 1,
+		sprite->line, sprite->line + sprite->lines - 1);
+	return;
+} // end lcd_sprite_window
+
+
+//******************************************************************************
+//	erase sprite (write back saved words)
+//
+static void lcd_sprite_erase(SPRITE* sprite)
+{
+	if (sprite->epoch == lcd_epoch)		// else display was cleared
+	{
+		lcd_sprite_window(sprite);
+		WriteCmd(0x5c);					// RAMWR - write to memory
+		lcd_write_burst(sprite->save, sprite->words * sprite->lines);
+	}
+	sprite->flags &= ~SPRITE_DRAWN;
+	return;
+} // end lcd_sprite_erase
+
+
+//******************************************************************************
+//	draw sprite at x,y (save words under it first)
+//
+static void lcd_sprite_draw(SPRITE* sprite)
+{
+	const uint8* image = sprite->image;
+	int16 width = image[0];
+	int16 height = image[1];
+	int16 left = sprite->x;
+	int16 right = left + width - 1;
+	int16 bottom = sprite->y;
+	int16 top = bottom + height - 1;
+	int16 col, last, i, j, k, p;
+	uint16 row[SPRITE_ROW_WORDS];
+	uint16* save;
+	uint8 bits, mask;
+
+	if (left < 0) left = 0;				// clip to screen
+	if (right >= HD_X_MAX) right = HD_X_MAX - 1;
+	if (bottom < 0) bottom = 0;
+	if (top >= HD_Y_MAX) top = HD_Y_MAX - 1;
+	if ((left > right) || (bottom > top)) return;	// off screen
+
+	sprite->first = divu3(159 - right);	// bounding words
+	last = divu3(159 - left);
+	sprite->words = last - sprite->first + 1;
+	sprite->line = bottom;
+	sprite->lines = top - bottom + 1;
+	sprite->epoch = lcd_epoch;
+
+	// save words under sprite (one block read)
+	lcd_sprite_window(sprite);
+	WriteCmd(0x5d);						// RAMRD - read from memory
+	ReadData();							// Dummy read
+	save = sprite->save;
+	for (i = sprite->words * sprite->lines; i > 0; --i)
+	{
+		j = ReadData() << 8;
+		*save++ = j + ReadData();
+	}
+
+	// draw rows bottom up (window order)
+	WriteCmd(0x5c);						// RAMWR - write to memory
+	save = sprite->save;
+	for (j = bottom; j <= top; ++j)
+	{
+		for (k = 0; k < sprite->words; ++k) row[k] = *save++;
+
+		bits = image[2 + (sprite->y + height - 1 - j)];	// top row first
+		col = 159 - sprite->x;			// RAM column of image pixel 0
+		k = divu3(col);
+		p = col - k - k - k;
+		k -= sprite->first;
+		for (mask = 0x80, i = 0; i < width; ++i, mask >>= 1)
+		{
+			if ((bits & mask) && (k >= 0) && (k < sprite->words))
+			{
+				if (sprite->mode == SPRITE_XOR) row[k] ^= lcd_pixel_bits[p];
+				else row[k] &= ~lcd_pixel_bits[p];		// pixel on
+			}
+			if (--p < 0)				// next pixel to the right
+			{
+				p = 2;
+				--k;
+			}
+		}
+		lcd_write_burst(row, sprite->words);
+	}
+	sprite->flags |= SPRITE_DRAWN;
+	return;
+} // end lcd_sprite_draw
+
+
+//******************************************************************************
+//	bus transactions to redraw a sprite
+//
+static uint16 lcd_sprite_cost(SPRITE* sprite)
+{
+	uint16 cost = 0;
+	uint16 words = divu3(sprite->image[0] + 4) * sprite->image[1];
+
+	if (sprite->flags & SPRITE_DRAWN) cost += 7 + (words << 1);		// erase
+	if (sprite->flags & SPRITE_SHOW) cost += 9 + (words << 2);		// draw
+	return cost;
+} // end lcd_sprite_cost
+
+
+//******************************************************************************
+//	Sprite functions:
+//
+//	uint8 lcd_sprite_init(uint8 id, const uint8* image, uint8 mode)
+//	void lcd_sprite_move(uint8 id, int16 x, int16 y)
+//	void lcd_sprite_hide(uint8 id)
+//	uint16 lcd_sprite_update(uint16 budget)
+//
+//******************************************************************************
+//	define sprite id (0 - SPRITE_MAX-1)
+//
+//	IN:		image	->	uint8 width (1-8)
+//						uint8 height (1-8)
+//						(8-bit row value) x height, top row first
+//			mode	SPRITE_SET = draw image pixels on
+//					SPRITE_XOR = invert display under image pixels
+//
+//	OUT:	return 0 (1 if bad id or image)
+//
+uint8 lcd_sprite_init(uint8 id, const uint8* image, uint8 mode)
+{
+	SPRITE* sprite = &lcd_sprites[id];
+
+	if ((id >= SPRITE_MAX) || (image[0] > 8) || (image[1] > 8)) return 1;
+	if (sprite->flags & SPRITE_DRAWN) lcd_sprite_erase(sprite);
+	memset(sprite, 0, sizeof(SPRITE));
+	sprite->image = image;
+	sprite->mode = mode;
+	sprite->flags = SPRITE_USED;
+	return 0;
+} // end lcd_sprite_init
+
+
+//******************************************************************************
+//	move sprite lower left to x,y and show it (drawn by lcd_sprite_update)
+//
+void lcd_sprite_move(uint8 id, int16 x, int16 y)
+{
+	SPRITE* sprite = &lcd_sprites[id];
+
+	if ((id >= SPRITE_MAX) || !(sprite->flags & SPRITE_USED)) return;
+	if ((sprite->flags & SPRITE_SHOW) && (x == sprite->x) && (y == sprite->y)
+		&& (sprite->epoch == lcd_epoch)) return;
+	sprite->x = x;
+	sprite->y = y;
+	sprite->flags |= SPRITE_SHOW | SPRITE_MOVED;
+	return;
+} // end lcd_sprite_move
+
+
+//******************************************************************************
+//	remove sprite from display now (restores saved words)
+//
+void lcd_sprite_hide(uint8 id)
+{
+	SPRITE* sprite = &lcd_sprites[id];
+
+	if (id >= SPRITE_MAX) return;
+	if (sprite->flags & SPRITE_DRAWN) lcd_sprite_erase(sprite);
+	sprite->flags &= ~(SPRITE_SHOW | SPRITE_MOVED);
+	return;
+} // end lcd_sprite_hide
+
+
+//******************************************************************************
+//	redraw moved sprites within budget bus transactions
+//
+//	OUT:	bus transactions used
+//
+uint16 lcd_sprite_update(uint16 budget)
+{
+	SPRITE* sprite;
+	uint16 used = 0;
+	uint16 cost;
+	uint8 i, id;
+
+	// sprites on a cleared display must be redrawn
+	for (i = 0; i < SPRITE_MAX; ++i)
+	{
+		sprite = &lcd_sprites[i];
+		if ((sprite->flags & SPRITE_DRAWN) && (sprite->epoch != lcd_epoch))
+		{
+			sprite->flags = (sprite->flags & ~SPRITE_DRAWN) | SPRITE_MOVED;
+		}
+	}
+
+	for (i = 0, id = lcd_sprite_next; i < SPRITE_MAX; ++i)
+	{
+		sprite = &lcd_sprites[id];
+		if (sprite->flags & SPRITE_MOVED)
+		{
+			cost = lcd_sprite_cost(sprite);
+			if (used && (used + cost > budget)) break;	// next frame
+			if (sprite->flags & SPRITE_DRAWN) lcd_sprite_erase(sprite);
+			lcd_sprite_draw(sprite);
+			sprite->flags &= ~SPRITE_MOVED;
+			used += cost;
+		}
+		if (++id >= SPRITE_MAX) id = 0;
+	}
+	lcd_sprite_next = id;				// start with first skipped sprite
+	return used;
+} // end lcd_sprite_update
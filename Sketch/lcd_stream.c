@@ -0,0 +1,241 @@
+//	lcd_stream.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Image streams for YM160160C/ST7529 LCD
+//
+//	lcd_wordImage data (width, height, then ccfx coded words) can come from
+//	a stream instead of a flash array, so splash images can live off chip.
+//	The run decoder (lcd_job_row) asks the stream for the next chunk of
+//	words when it runs out; a stream source is:
+//
+//		flash	the image array is one chunk (nothing copied)
+//		FRAM	LCD_STREAM_WORDS word chunks read over I2C, double buffered
+//				- the next chunk is read on the I2C interrupts while the
+//				decoder writes the current one to the LCD
+//		UART	LCD_STREAM_WORDS word chunks taken from the receive ring
+//				(the ring fills from the RX interrupt meanwhile)
+//
+//	Stream words are stored as in the flash array (uint16, low byte first),
+//	so an image table can be copied to FRAM or sent over the UART as is.
+//
+//	RAM does not grow with the image: a LCD_STREAM is 26 bytes, the FRAM
+//	source adds 16 bytes (I2C transaction and address) and lcd_streamImage
+//	has a 18 byte LCD_JOB on the stack - 60 bytes at the peak (MSP430
+//	sizes).  Only one FRAM stream may run at a time.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+#include "RBX430_uart.h"
+#include "RBX430_i2c.h"
+#include "RBX430_fram.h"
+#include "RBX430_telemetry.h"
+
+#define STREAM_UART_MS	250				// UART byte timeout
+
+static I2C_XFER stream_xfer;			// FRAM chunk read
+static uint8 stream_at[2];				// 	FRAM address
+
+
+//******************************************************************************
+//	flash source - the whole image is one chunk
+//
+static const uint16* stream_flash_next(LCD_STREAM* stream, uint16* count)
+{
+	if (!stream->left) return 0;		// decoder ran past the image
+	*count = stream->left;
+	stream->left = 0;
+	return stream->flash;
+} // end stream_flash_next
+
+
+//******************************************************************************
+//	start FRAM read of next chunk into stream->buf[stream->b]
+//
+static void stream_fram_fetch(LCD_STREAM* stream)
+{
+	uint16 n = (stream->left < LCD_STREAM_WORDS) ?
+		stream->left : LCD_STREAM_WORDS;
+
+	stream_xfer.rcount = n * 2;
+	if (!n) return;
+	stream_at[0] = stream->addr >> 8;
+	stream_at[1] = stream->addr & 0xff;
+	stream_xfer.rdata = (uint8*)stream->buf[stream->b];
+	while (i2c_submit(&stream_xfer));	// (queue full)
+	stream->addr += n * 2;
+	stream->left -= n;
+	return;
+} // end stream_fram_fetch
+
+
+//******************************************************************************
+//	FRAM source - wait for fetched chunk, start fetching the next one
+//
+static const uint16* stream_fram_next(LCD_STREAM* stream, uint16* count)
+{
+	uint16* chunk = stream->buf[stream->b];
+
+	*count = stream_xfer.rcount >> 1;
+	if (!*count) return 0;				// decoder ran past the image
+	if (i2c_wait(&stream_xfer))
+	{
+		stream->error = SYS_ERR_FRAM;
+		stream->left = 0;
+		stream_xfer.rcount = 0;
+		return 0;
+	}
+	stream->b ^= 1;						// (decoder is done with this one)
+	stream_fram_fetch(stream);
+	return chunk;
+} // end stream_fram_next
+
+
+//******************************************************************************
+//	UART source - next chunk from the receive ring
+//
+//	A byte that does not come within STREAM_UART_MS ends the stream (timed
+//	on tm_time - Timer A, started by tm_init - not on loop passes).
+//
+static const uint16* stream_uart_next(LCD_STREAM* stream, uint16* count)
+{
+	uint8* chunk = (uint8*)stream->buf[0];
+	uint16 n = (stream->left < LCD_STREAM_WORDS) ?
+		stream->left : LCD_STREAM_WORDS;
+	uint16 i, start, idle;
+	int16 c;
+
+	if (!n) return 0;					// decoder ran past the image
+	for (i = 0; i < n * 2; ++i)			// (low byte first)
+	{
+		start = tm_time();
+		idle = 0;						// ms without a byte
+		while ((c = uart_getc()) < 0)
+		{
+			if ((uint16)(tm_time() - start) < tm_ticks_ms) continue;
+			start += tm_ticks_ms;
+			if (++idle >= STREAM_UART_MS)	// gave up waiting
+			{
+				stream->error = SYS_ERR_UART_TO;
+				stream->left = 0;
+				return 0;
+			}
+		}
+		chunk[i] = c;
+	}
+	stream->left -= n;
+	*count = n;
+	return stream->buf[0];
+} // end stream_uart_next
+
+
+//******************************************************************************
+//	Image stream functions:
+//
+//	void lcd_stream_flash(LCD_STREAM* stream, const uint16* image)
+//	void lcd_stream_fram(LCD_STREAM* stream, uint16 addr, uint16 bytes)
+//	void lcd_stream_uart(LCD_STREAM* stream, uint16 bytes)
+//	uint8 lcd_streamImage(LCD_STREAM* stream, int16 x, int16 y, uint8 flag)
+//	void lcd_job_stream(LCD_JOB* job, LCD_STREAM* stream, int16 x, int16 y,
+//		uint8 flag)
+//
+//******************************************************************************
+//	stream lcd_wordImage array from flash
+//
+void lcd_stream_flash(LCD_STREAM* stream, const uint16* image)
+{
+	stream->next = stream_flash_next;
+	stream->flash = image;
+	stream->left = 0xffff;				// (not known - one chunk)
+	stream->error = 0;
+	return;
+} // end lcd_stream_flash
+
+
+//******************************************************************************
+//	stream image from FRAM (call after i2c_init - first chunk is started)
+//
+//	IN:		addr, bytes		image in FRAM (see fram_find)
+//
+void lcd_stream_fram(LCD_STREAM* stream, uint16 addr, uint16 bytes)
+{
+	stream->next = stream_fram_next;
+	stream->addr = addr;
+	stream->left = bytes >> 1;
+	stream->b = 0;
+	stream->error = 0;
+	stream_xfer.addr = FRAM_ADDR;
+	stream_xfer.ms = 0;
+	stream_xfer.wdata = stream_at;
+	stream_xfer.wcount = 2;
+	stream_xfer.done = 0;
+	stream_fram_fetch(stream);
+	return;
+} // end lcd_stream_fram
+
+
+//******************************************************************************
+//	stream image from the UART (call after uart_init and tm_init)
+//
+//	IN:		bytes		image size (the sender's bytes are not acknowledged
+//						- the receive ring must not overflow, so the baud
+//						rate must be below the LCD decode rate)
+//
+void lcd_stream_uart(LCD_STREAM* stream, uint16 bytes)
+{
+	stream->next = stream_uart_next;
+	stream->left = bytes >> 1;
+	stream->error = 0;
+	return;
+} // end lcd_stream_uart
+
+
+//******************************************************************************
+//	output streamed lcd_wordImage (flag as lcd_wordImage)
+//
+//	OUT:	return 0 (SYS_ERR_... if the source failed - the rest of the
+//			image is blank)
+//
+uint8 lcd_streamImage(LCD_STREAM* stream, int16 x, int16 y, uint8 flag)
+{
+	LCD_JOB job;
+
+	lcd_job_stream(&job, stream, x, y, flag);
+	lcd_job_run(&job, 0);				// all rows
+	if ((stream->next == stream_fram_next) && stream_xfer.rcount)
+	{
+		i2c_wait(&stream_xfer);			// (bytes past the image)
+	}
+	return stream->error;
+} // end lcd_streamImage
+
+
+//******************************************************************************
+//	set up streamed lcd_wordImage job (lcd_job_run draws it)
+//
+void lcd_job_stream(LCD_JOB* job, LCD_STREAM* stream, int16 x, int16 y,
+	uint8 flag)
+{
+	const uint16* image = 0;
+	uint16 count = 0;
+	uint16 size[2];						// width, height
+	uint8 i;
+
+	for (i = 0; i < 2; ++i)
+	{
+		if (!count) image = stream->next(stream, &count);
+		if (!image)
+		{
+			lcd_job_fill(job, x, y, 0, 0, 0);	// (no rows)
+			return;
+		}
+		size[i] = *image++;
+		--count;
+	}
+	lcd_job_fill(job, x, y, size[0], size[1], flag);
+	job->image = image;
+	job->count = count;
+	job->stream = stream;
+	return;
+} // end lcd_job_stream
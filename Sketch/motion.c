@@ -0,0 +1,172 @@
+//	motion.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Etch-a-Sketch accelerometer gestures (shake and tilt)
+//
+//	Samples come from the ADXL345 FIFO ring (xl_read) in batches, one batch
+//	per FIFO watermark - nothing here talks to the accelerometer.  All math
+//	is shifts, adds and compares (the MSP430F2274 has no multiplier).
+//
+//	Shake:	magnitude is estimated as max + (mid + min) / 2 of |x|,|y|,|z|
+//			(within ~15% of the true length).  A crossing is the magnitude
+//			rising above SHAKE_G after falling below SHAKE_G - SHAKE_HYST.
+//			SHAKE_COUNT crossings within SHAKE_WINDOW samples is a shake;
+//			then nothing is detected for SHAKE_HOLDOFF samples.
+//
+//			Time is counted in samples, so a main loop stall only delays
+//			detection while the ADXL345 FIFO keeps every sample - up to
+//			~350ms at 100Hz (RBX430_adxl345.c).  Stalls in this program
+//			(8MHz, 100kHz I2C - test/test_motion.cpp):
+//				queued clear (lcd_queue_run continue)	9 x 2ms slices
+//				canvas store/load of a busy drawing		~0.5s (I2C alone)
+//				screenshot PGM/PBM at 115200			~2.3s/~0.3s
+//				stroke replay							CPU bound (not timed)
+//			A longer stall loses samples (xl_lost changes) - crossings
+//			before the gap are forgotten, so two halves of separate
+//			shakes never add up to one.  A shake made during a long stall
+//			is missed unless its end is still in the FIFO.
+//
+//	Tilt:	x and y are low pass filtered (1/8 new sample) and steer the
+//			pen like a ball rolling downhill - velocity is the filtered
+//			tilt outside a TILT_DEAD zone; 1 g moves the pen 1 pixel per
+//			sample (100 pixels/second at 100Hz).  Position is kept in 1/64
+//			pixels.  The ADXL345 x and y axes are taken to point right and
+//			up on the display.
+//******************************************************************************
+//
+#include <stdlib.h>
+
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+#include "RBX430_adxl345.h"
+#include "etch-a-sketch.h"
+
+#define SHAKE_G			(XL_1G * 2)		// crossing threshold
+#define SHAKE_HYST		(XL_1G / 2)		// 	must fall this far below first
+#define SHAKE_COUNT		4				// crossings (power of 2)
+#define SHAKE_WINDOW	64				// 	within samples (~0.64s @100Hz)
+#define SHAKE_HOLDOFF	100				// samples ignored after a shake
+
+#define TILT_DEAD		(XL_1G / 16)	// filtered g ignored (~0.06g)
+#define TILT_SHIFT		2				// 1g = 64/64 pixel per sample
+#define TILT_MAX		(159 << 6)		// position limit (1/64 pixels)
+
+static uint16 motion_n;					// samples seen
+static uint16 shake_at[SHAKE_COUNT];	// sample number of last crossings
+static uint8 shake_i;					// 	next shake_at
+static uint8 shake_cnt;					// 	valid shake_at (to SHAKE_COUNT)
+static uint8 shake_armed;				// 	below SHAKE_G - SHAKE_HYST
+static uint16 shake_hold;				// samples to ignore
+static uint16 shake_lost;				// xl_lost seen
+
+static int16 tilt_x, tilt_y;			// filtered x, y (g * XL_1G)
+static int16 pen_x, pen_y;				// pen position (1/64 pixels)
+
+
+//******************************************************************************
+//	move pen coordinate by tilt
+//
+static int16 tilt_move(int16 pos, int16 tilt)
+{
+	if (tilt > TILT_DEAD) pos -= (tilt - TILT_DEAD) >> TILT_SHIFT;	// downhill
+	else if (tilt < -TILT_DEAD) pos -= (tilt + TILT_DEAD) >> TILT_SHIFT;
+	if (pos < 0) pos = 0;
+	if (pos > TILT_MAX) pos = TILT_MAX;
+	return pos;
+} // end tilt_move
+
+
+//******************************************************************************
+//	Motion functions:
+//
+//	uint16 motion_magnitude(const XL_SAMPLE* sample)
+//	uint8 motion_shake(const XL_SAMPLE* sample)
+//	void motion_tilt_start(int x, int y)
+//	void motion_tilt(const XL_SAMPLE* sample, int* x, int* y)
+//
+//******************************************************************************
+//	estimate sample magnitude (max + (mid + min) / 2)
+//
+//	OUT:	return |sample| (g * XL_1G)
+//
+uint16 motion_magnitude(const XL_SAMPLE* sample)
+{
+	uint16 a = abs(sample->x);
+	uint16 b = abs(sample->y);
+	uint16 c = abs(sample->z);
+	uint16 t;
+
+	if (a < b) { t = a; a = b; b = t; }	// a = max
+	if (a < c) { t = a; a = c; c = t; }
+	return a + ((b + c) >> 1);
+} // end motion_magnitude
+
+
+//******************************************************************************
+//	shake detector - call with every sample
+//
+//	OUT:	return 1 if shaken
+//
+uint8 motion_shake(const XL_SAMPLE* sample)
+{
+	uint16 mag = motion_magnitude(sample);
+	uint16 n = ++motion_n;
+
+	if (xl_lost != shake_lost)			// samples lost - start over
+	{
+		shake_lost = xl_lost;
+		shake_cnt = 0;
+	}
+	if (shake_hold)
+	{
+		--shake_hold;
+		return 0;
+	}
+	if (mag < SHAKE_G - SHAKE_HYST)
+	{
+		shake_armed = 1;
+		return 0;
+	}
+	if (!shake_armed || (mag < SHAKE_G)) return 0;
+
+	shake_armed = 0;					// crossing
+	shake_at[shake_i] = n;
+	shake_i = (shake_i + 1) & (SHAKE_COUNT - 1);	// (now oldest)
+	if (shake_cnt < SHAKE_COUNT) ++shake_cnt;
+	if ((shake_cnt < SHAKE_COUNT)
+		|| ((uint16)(n - shake_at[shake_i]) >= SHAKE_WINDOW)) return 0;
+
+	shake_hold = SHAKE_HOLDOFF;
+	shake_cnt = 0;						// start over
+	return 1;
+} // end motion_shake
+
+
+//******************************************************************************
+//	start tilt steering at pen x, y
+//
+void motion_tilt_start(int x, int y)
+{
+	pen_x = x << 6;
+	pen_y = y << 6;
+	tilt_x = tilt_y = 0;
+	return;
+} // end motion_tilt_start
+
+
+//******************************************************************************
+//	tilt steering - call with every sample
+//
+//	OUT:	*x, *y = pen position (pixels)
+//
+void motion_tilt(const XL_SAMPLE* sample, int* x, int* y)
+{
+	tilt_x += (sample->x - tilt_x) >> 3;	// low pass
+	tilt_y += (sample->y - tilt_y) >> 3;
+	pen_x = tilt_move(pen_x, tilt_x);
+	pen_y = tilt_move(pen_y, tilt_y);
+	*x = pen_x >> 6;
+	*y = pen_y >> 6;
+	return;
+} // end motion_tilt
@@ -0,0 +1,269 @@
+//	stroke_log.c
+//******************************************************************************
+//******************************************************************************
+//	Description:	Etch-a-Sketch stroke log (undo and replay)
+//
+//	Every line segment drawn is recorded so the drawing can be replayed
+//	after a clear and the last stroke can be undone.  A stroke is a run of
+//	connected segments drawn with one pen (it ends when the pen rests or
+//	changes size).
+//
+//	Log format (bytes):
+//		0x81-0x8f, x, y		stroke start (pen = low nibble) at x,y
+//		0x80, x, y			segment to x,y (long move)
+//		dx:dy				segment by dx (-7..7), dy (-8..7) (4-bit nibbles)
+//
+//	Most segments are one byte, so STROKE_LOG_SIZE bytes hold nearly as
+//	many segments.
+//
+//	Overflow: when a new segment does not fit, the oldest strokes are
+//	dropped.  They stay on the display but are no longer replayed, and an
+//	undo that crosses them can leave gaps.  If one stroke alone fills the
+//	log, its oldest segments are dropped the same way and the stroke
+//	starts again where the kept segments begin.
+//
+//	Undo erases the last stroke (drawn again with its pen off) and then
+//	replays only the strokes whose bounding box overlaps it, to repair
+//	the pixels they shared - the rest of the canvas is not touched.
+//******************************************************************************
+//
+#include <string.h>
+
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+#include "etch-a-sketch.h"
+
+#define STROKE_JUMP		0x80			// long segment code
+#define STROKE_START	0x80			// | pen (1-15)
+#define STROKE_CODE		0x80			// high nibble of codes
+
+#define STROKE_BOX		0				// stroke_scan modes
+#define STROKE_DRAW		1
+#define STROKE_ERASE	2
+
+static uint8 stroke_log[STROKE_LOG_SIZE];
+static uint16 stroke_len;				// bytes used
+static uint8 stroke_open;				// last stroke can be extended
+static uint8 stroke_pen;				// 	with this pen
+static uint8 stroke_x, stroke_y;		// 	from this point
+
+static int16 box_left, box_right;		// stroke_scan bounding box
+static int16 box_bottom, box_top;
+
+
+//******************************************************************************
+//	walk stroke starting at stroke_log[i]
+//
+//	IN:		mode	STROKE_BOX = bounding box only
+//					STROKE_DRAW = draw segments with stroke pen
+//					STROKE_ERASE = draw segments with pen off
+//
+//	OUT:	return index of next stroke (box_ = bounding box + pen size)
+//
+static uint16 stroke_scan(uint16 i, uint8 mode)
+{
+	int16 x, y, x1, y1;
+	uint8 code = stroke_log[i];
+	int16 pen = code & 0x0f;
+
+	if (mode == STROKE_ERASE) pen &= ~0x01;
+	x = box_left = box_right = stroke_log[i + 1];
+	y = box_bottom = box_top = stroke_log[i + 2];
+	for (i += 3; i < stroke_len; )
+	{
+		code = stroke_log[i];
+		if ((code & 0xf0) == STROKE_CODE)
+		{
+			if (code != STROKE_JUMP) break;		// next stroke
+			x1 = stroke_log[i + 1];
+			y1 = stroke_log[i + 2];
+			i += 3;
+		}
+		else
+		{
+			x1 = x + (((code >> 4) ^ 0x08) - 0x08);	// sign extend nibbles
+			y1 = y + (((code & 0x0f) ^ 0x08) - 0x08);
+			++i;
+		}
+		if (mode != STROKE_BOX) plotline(x, y, x1, y1, pen);
+		x = x1;
+		y = y1;
+		if (x < box_left) box_left = x;
+		if (x > box_right) box_right = x;
+		if (y < box_bottom) box_bottom = y;
+		if (y > box_top) box_top = y;
+	}
+	box_left -= 2;						// largest pen reaches 2 pixels
+	box_right += 2;
+	box_bottom -= 2;
+	box_top += 2;
+	return i;
+} // end stroke_scan
+
+
+//******************************************************************************
+//	make room for n bytes (drop oldest strokes, then oldest segments of
+//	the only stroke left)
+//
+static void stroke_room(uint16 n)
+{
+	uint16 i, next;
+	uint8 code;
+	uint8 x, y;
+
+	while (stroke_len + n > STROKE_LOG_SIZE)
+	{
+		next = stroke_scan(0, STROKE_BOX);	// end of oldest stroke
+		if (next >= stroke_len)				// only one stroke left
+		{
+			code = stroke_log[0];
+			x = stroke_log[1];
+			y = stroke_log[2];
+			for (i = 3; (i < stroke_len) && (stroke_len - i + 3 + n
+				> STROKE_LOG_SIZE); )
+			{
+				if (stroke_log[i] == STROKE_JUMP)
+				{
+					x = stroke_log[i + 1];
+					y = stroke_log[i + 2];
+					i += 3;
+				}
+				else
+				{
+					x += ((stroke_log[i] >> 4) ^ 0x08) - 0x08;
+					y += ((stroke_log[i] & 0x0f) ^ 0x08) - 0x08;
+					++i;
+				}
+			}
+			next = i - 3;					// restart stroke at x,y
+			stroke_log[next] = code;
+			stroke_log[next + 1] = x;
+			stroke_log[next + 2] = y;
+		}
+		memmove(stroke_log, stroke_log + next, stroke_len - next);
+		stroke_len -= next;
+	}
+	return;
+} // end stroke_room
+
+
+//******************************************************************************
+//	Stroke log functions:
+//
+//	void stroke_clear(void)
+//	void stroke_add(int x0, int y0, int x1, int y1, int pen)
+//	void stroke_end(void)
+//	uint8 stroke_undo(void)
+//	void stroke_replay(void)
+//
+//******************************************************************************
+//	empty log (display cleared)
+//
+void stroke_clear(void)
+{
+	stroke_len = 0;
+	stroke_open = 0;
+	return;
+} // end stroke_clear
+
+
+//******************************************************************************
+//	record segment x0,y0 to x1,y1 (extends open stroke if it ends at x0,y0)
+//
+//	IN:		pen		lcd_point flag (odd = on, 1-15)
+//
+void stroke_add(int x0, int y0, int x1, int y1, int pen)
+{
+	int dx = x1 - x0;
+	int dy = y1 - y0;
+	uint8 start;
+	uint16 n;
+
+	if (!(pen & 0x01)) return;				// only pen on segments
+	start = !stroke_open || (pen != stroke_pen) || (x0 != stroke_x)
+		|| (y0 != stroke_y);
+	n = ((dx >= -7) && (dx <= 7) && (dy >= -8) && (dy <= 7)) ? 1 : 3;
+	stroke_room(n + (start ? 3 : 0));
+
+	if (start)
+	{
+		stroke_log[stroke_len++] = STROKE_START | (pen & 0x0f);
+		stroke_log[stroke_len++] = x0;
+		stroke_log[stroke_len++] = y0;
+	}
+	if (n == 1)
+	{
+		stroke_log[stroke_len++] = (dx << 4) | (dy & 0x0f);
+	}
+	else
+	{
+		stroke_log[stroke_len++] = STROKE_JUMP;
+		stroke_log[stroke_len++] = x1;
+		stroke_log[stroke_len++] = y1;
+	}
+	stroke_open = 1;
+	stroke_pen = pen;
+	stroke_x = x1;
+	stroke_y = y1;
+	return;
+} // end stroke_add
+
+
+//******************************************************************************
+//	end open stroke (next segment starts a new stroke)
+//
+void stroke_end(void)
+{
+	stroke_open = 0;
+	return;
+} // end stroke_end
+
+
+//******************************************************************************
+//	remove last stroke from log and display
+//
+//	OUT:	return 0 (1 if log empty)
+//
+uint8 stroke_undo(void)
+{
+	uint16 i, last, next;
+	int16 left, right, bottom, top;
+
+	if (stroke_len == 0) return 1;
+	stroke_open = 0;
+
+	for (i = 0; (next = stroke_scan(i, STROKE_BOX)) < stroke_len; i = next);
+	last = i;								// start of last stroke
+	stroke_scan(last, STROKE_ERASE);
+	left = box_left;
+	right = box_right;
+	bottom = box_bottom;
+	top = box_top;
+	stroke_len = last;
+
+	// repair strokes that shared pixels with it
+	for (i = 0; i < stroke_len; i = next)
+	{
+		next = stroke_scan(i, STROKE_BOX);
+		if ((box_left <= right) && (box_right >= left)
+			&& (box_bottom <= top) && (box_top >= bottom))
+		{
+			stroke_scan(i, STROKE_DRAW);
+		}
+	}
+	return 0;
+} // end stroke_undo
+
+
+//******************************************************************************
+//	redraw all logged strokes (call after lcd_clear)
+//
+void stroke_replay(void)
+{
+	uint16 i;
+
+	stroke_open = 0;
+	for (i = 0; i < stroke_len; i = stroke_scan(i, STROKE_DRAW));
+	return;
+} // end stroke_replay
@@ -0,0 +1,71 @@
+//	lcd_bus.c - host stand-in for RBX430_lcd_bus.asm
+//******************************************************************************
+//******************************************************************************
+//	Description:	The three burst writers with the same port sequence as
+//					the assembly: P2 driven, RW low and A0 high once per
+//					call, then a byte on P2OUT and an E strobe per byte.
+//					A solid word (both bytes equal, ignoring bit 5) puts
+//					its byte on P2 once and only strobes E.
+//******************************************************************************
+//
+#include "msp430x22x4.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+static void lcd_bus_data(void)
+{
+	P2DIR = 0xff;
+	LCD_RW_L;
+	LCD_A0_H;
+	return;
+} // end lcd_bus_data
+
+
+static void lcd_bus_word(uint16 word)
+{
+	P2OUT = word >> 8;
+	LCD_E_H;
+	LCD_E_L;
+	P2OUT = word;
+	LCD_E_H;
+	LCD_E_L;
+	return;
+} // end lcd_bus_word
+
+
+void lcd_write_burst(const uint16* src, uint16 count)
+{
+	if (!count) return;
+	lcd_bus_data();
+	while (count--) lcd_bus_word(*src++);
+	return;
+} // end lcd_write_burst
+
+
+void lcd_write_burst_inv(const uint16* src, uint16 count)
+{
+	if (!count) return;
+	lcd_bus_data();
+	while (count--) lcd_bus_word(~*src++);
+	return;
+} // end lcd_write_burst_inv
+
+
+void lcd_write_repeat(uint16 word, uint16 count)
+{
+	if (!count) return;
+	lcd_bus_data();
+	if ((((word >> 8) ^ word) & 0xdf) == 0)	// solid - strobes only
+	{
+		P2OUT = word >> 8;
+		count <<= 1;
+		while (count--)
+		{
+			LCD_E_H;
+			LCD_E_L;
+		}
+		return;
+	}
+	while (count--) lcd_bus_word(word);
+	return;
+} // end lcd_write_repeat
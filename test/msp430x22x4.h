@@ -0,0 +1,189 @@
+//	msp430x22x4.h - host register model for the driver tests
+//******************************************************************************
+//******************************************************************************
+//	Description:	Stands in for the TI device header when the Sketch drivers
+//					are built on a PC (test/Makefile).
+//
+//	Each peripheral register is a small object.  Writes can call a hook
+//	(the peripheral models in sim.cpp react to them) and reads can call a
+//	hook (Timer A counts on reads of TAR, reading UCA0RXBUF clears
+//	UCA0RXIFG, ...).  Only the registers and bits the drivers use are here.
+//
+//	The status register is a plain variable.  Setting GIE runs pending
+//	interrupts, and setting CPUOFF runs the models until an ISR clears it
+//	(sim_sleep).  ISRs run with GIE clear; __bic_SR_register_on_exit
+//	changes the SR that is restored when the ISR returns.
+//******************************************************************************
+//
+#ifndef MSP430X22X4_HOST_H_
+#define MSP430X22X4_HOST_H_
+
+#include <stdint.h>
+
+struct Reg8
+{
+	volatile uint8_t v;
+	void (*wr)(uint8_t was, uint8_t now);	// write hook (or 0)
+	void (*rd)(void);						// read hook (or 0)
+
+	Reg8& operator=(unsigned x)
+	{
+		uint8_t was = v;
+		v = (uint8_t)x;
+		if (wr) wr(was, v);
+		return *this;
+	}
+	Reg8& operator|=(unsigned x) { return *this = v | x; }
+	Reg8& operator&=(unsigned x) { return *this = v & x; }
+	Reg8& operator^=(unsigned x) { return *this = v ^ x; }
+	operator unsigned()
+	{
+		if (rd) rd();
+		return v;
+	}
+};
+
+struct Reg16
+{
+	volatile uint16_t v;
+	void (*wr)(uint16_t was, uint16_t now);
+	void (*rd)(void);
+
+	Reg16& operator=(unsigned x)
+	{
+		uint16_t was = v;
+		v = (uint16_t)x;
+		if (wr) wr(was, v);
+		return *this;
+	}
+	Reg16& operator|=(unsigned x) { return *this = v | x; }
+	Reg16& operator&=(unsigned x) { return *this = v & x; }
+	Reg16& operator+=(unsigned x) { return *this = v + x; }
+	Reg16& operator-=(unsigned x) { return *this = v - x; }
+	operator unsigned()
+	{
+		if (rd) rd();
+		return v;
+	}
+};
+
+//	ports
+extern Reg8 P1IN, P1OUT, P1DIR, P1IFG, P1IES, P1IE, P1SEL, P1REN;
+extern Reg8 P2IN, P2OUT, P2DIR, P2SEL, P2REN;
+extern Reg8 P3IN, P3OUT, P3DIR, P3SEL, P3REN;
+extern Reg8 P4IN, P4OUT, P4DIR, P4SEL, P4REN;
+
+//	clocks, special function registers
+extern Reg8 BCSCTL1, BCSCTL3, DCOCTL;
+extern Reg8 CALBC1_1MHZ, CALBC1_8MHZ, CALBC1_12MHZ, CALBC1_16MHZ;
+extern Reg8 CALDCO_1MHZ, CALDCO_8MHZ, CALDCO_12MHZ, CALDCO_16MHZ;
+extern Reg8 IE1, IE2, IFG2;
+extern Reg16 WDTCTL;
+
+//	Timer A
+extern Reg16 TACTL, TAR, TAIV, TACCTL0, TACCR0, TACCTL1, TACCR1;
+
+//	USCI_A0 (UART) and USCI_B0 (I2C)
+extern Reg8 UCA0CTL0, UCA0CTL1, UCA0BR0, UCA0BR1, UCA0MCTL, UCA0STAT;
+extern Reg8 UCA0RXBUF, UCA0TXBUF;
+extern Reg8 UCB0CTL0, UCB0CTL1, UCB0BR0, UCB0BR1, UCB0I2CIE, UCB0STAT;
+extern Reg8 UCB0RXBUF, UCB0TXBUF;
+extern Reg16 UCB0I2CSA;
+
+//	ADC10
+extern Reg8 ADC10AE0, ADC10AE1;
+extern Reg16 ADC10CTL0, ADC10CTL1, ADC10MEM;
+
+//	status register
+#define GIE					0x0008
+#define CPUOFF				0x0010
+#define LPM0_bits			(CPUOFF)
+
+extern volatile unsigned SR;			// status register
+extern unsigned sim_sr_exit;			// SR restored by the running ISR
+void sim_gie(void);						// run pending interrupts
+void sim_sleep(void);					// run models while CPUOFF
+
+#define __get_SR_register()				(SR)
+#define __bis_SR_register(x)			((SR |= (x)), sim_gie(), sim_sleep())
+#define __bic_SR_register(x)			((void)(SR &= ~(x)))
+#define __bis_SR_register_on_exit(x)	((void)(sim_sr_exit |= (x)))
+#define __bic_SR_register_on_exit(x)	((void)(sim_sr_exit &= ~(x)))
+#define __enable_interrupt()			__bis_SR_register(GIE)
+#define __disable_interrupt()			__bic_SR_register(GIE)
+#define _no_operation()					((void)0)
+#define __no_operation()				((void)0)
+
+//	interrupt vectors (#pragma vector is ignored on the host)
+#define __interrupt
+#define TIMERA1_VECTOR		0
+#define USCIAB0RX_VECTOR	0
+#define USCIAB0TX_VECTOR	0
+#define PORT1_VECTOR		0
+#define WDT_VECTOR			0
+#define ADC10_VECTOR		0
+
+//	IE1, IE2, IFG2
+#define WDTIE				0x01
+#define UCA0RXIE			0x01
+#define UCA0TXIE			0x02
+#define UCB0RXIE			0x04
+#define UCB0TXIE			0x08
+#define UCA0RXIFG			0x01
+#define UCA0TXIFG			0x02
+#define UCB0RXIFG			0x04
+#define UCB0TXIFG			0x08
+
+//	WDTCTL
+#define WDTPW				0x5a00
+#define WDTHOLD				0x0080
+
+//	BCSCTL3
+#define LFXT1S_2			0x20
+
+//	Timer A
+#define TASSEL_2			0x0200		// TACTL
+#define ID_3				0x00c0
+#define MC_1				0x0010
+#define MC_2				0x0020
+#define TACLR				0x0004
+#define CCIE				0x0010		// TACCTLx
+#define CCIFG				0x0001
+#define TAIV_TACCR1			0x0002
+
+//	USCI_A0
+#define UCSSEL_2			0x80		// UCA0CTL1, UCB0CTL1
+#define UCSWRST				0x01
+#define UCBRS0				0x02		// UCA0MCTL
+#define UCBUSY				0x01		// UCA0STAT
+#define UCOE				0x20
+
+//	USCI_B0
+#define UCMST				0x08		// UCB0CTL0
+#define UCMODE_3			0x06
+#define UCSYNC				0x01
+#define UCTR				0x10		// UCB0CTL1
+#define UCTXNACK			0x08
+#define UCTXSTP				0x04
+#define UCTXSTT				0x02
+#define UCNACKIE			0x08		// UCB0I2CIE
+#define UCSTPIE				0x04
+#define UCSTTIE				0x02
+#define UCALIE				0x01
+#define UCBBUSY				0x10		// UCB0STAT
+#define UCNACKIFG			0x08
+#define UCSTPIFG			0x04
+#define UCSTTIFG			0x02
+#define UCALIFG				0x01
+
+//	ADC10
+#define SREF0				0x2000
+#define ADC10SHT_2			0x1000
+#define REF2_5V				0x0040
+#define REFON				0x0020
+#define ADC10ON				0x0010
+#define ENC					0x0002
+#define ADC10SC				0x0001
+#define ADC10IFG			0x0004
+
+#endif /*MSP430X22X4_HOST_H_*/
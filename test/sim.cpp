@@ -0,0 +1,647 @@
+//	sim.cpp - host models behind the register model (see sim.h)
+//******************************************************************************
+//******************************************************************************
+//
+#include <deque>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "RBX430-1.h"
+
+//	registers
+Reg8 P1IN, P1OUT, P1DIR, P1IFG, P1IES, P1IE, P1SEL, P1REN;
+Reg8 P2IN, P2OUT, P2DIR, P2SEL, P2REN;
+Reg8 P3IN, P3OUT, P3DIR, P3SEL, P3REN;
+Reg8 P4IN, P4OUT, P4DIR, P4SEL, P4REN;
+Reg8 BCSCTL1, BCSCTL3, DCOCTL;
+Reg8 CALBC1_1MHZ, CALBC1_8MHZ, CALBC1_12MHZ, CALBC1_16MHZ;
+Reg8 CALDCO_1MHZ, CALDCO_8MHZ, CALDCO_12MHZ, CALDCO_16MHZ;
+Reg8 IE1, IE2, IFG2;
+Reg16 WDTCTL;
+Reg16 TACTL, TAR, TAIV, TACCTL0, TACCR0, TACCTL1, TACCR1;
+Reg8 UCA0CTL0, UCA0CTL1, UCA0BR0, UCA0BR1, UCA0MCTL, UCA0STAT;
+Reg8 UCA0RXBUF, UCA0TXBUF;
+Reg8 UCB0CTL0, UCB0CTL1, UCB0BR0, UCB0BR1, UCB0I2CIE, UCB0STAT;
+Reg8 UCB0RXBUF, UCB0TXBUF;
+Reg16 UCB0I2CSA;
+Reg8 ADC10AE0, ADC10AE1;
+Reg16 ADC10CTL0, ADC10CTL1, ADC10MEM;
+
+volatile unsigned SR;
+unsigned sim_sr_exit;
+
+//	driver globals (RBX430-1.c is not linked - RBX430_init sets these)
+uint16 i2c_fSCL;
+uint16 mclk_kHz;
+
+//	ISRs of the code under test (weak - not every test links them)
+__attribute__((weak)) void TIMERA1_ISR(void);
+__attribute__((weak)) void USCIAB0RX_ISR(void);
+__attribute__((weak)) void USCIAB0TX_ISR(void);
+__attribute__((weak)) void PORT1_ISR(void);
+
+St7529 lcd_model;
+std::vector<uint8_t> uart_out;
+int sim_uart_loopback;
+long uart_overruns;
+std::string i2c_trace;
+long i2c_bytes;
+long isr_count;
+uint64_t isr_longest;
+int test_failures;
+
+static uint64_t sim_now;				// MCLK cycles
+static int sim_in_isr;
+
+static std::deque<uint8_t> uart_rx_line;	// bytes still to arrive
+static uint64_t uart_rx_at;				// next byte complete (0 = none)
+static uint64_t uart_tx_at;				// shift register empty (0 = idle)
+static uint8_t uart_tx_sh;				// 	byte shifting out
+static int uart_tx_full;				// UCA0TXBUF holds a byte
+
+enum { I_IDLE, I_ADDR, I_TX, I_RX, I_HOLD, I_STOP };
+static I2cSlave* i2c_slaves[128];
+static I2cSlave* i2c_slave;				// addressed slave
+static int i2c_state;
+static uint64_t i2c_at;					// phase complete
+static int i2c_read;					// receiving
+static int i2c_nacked;					// NACK - wait for stop or start
+static int i2c_tx_full;					// UCB0TXBUF holds a byte
+static uint8_t i2c_tx_sh;				// 	byte shifting out
+
+
+//******************************************************************************
+//	report helpers
+//
+void sim_fail(const char* what)
+{
+	printf("FAIL: %s (at %.3f ms)\n", what, sim_ms(sim_now));
+	exit(1);
+} // end sim_fail
+
+
+void ERROR2(int16 error)
+{
+	char what[32];
+
+	if (error == 0) return;
+	snprintf(what, sizeof(what), "ERROR2(%d)", error);
+	sim_fail(what);
+} // end ERROR2
+
+
+void check(int ok, const char* what, const char* file, int line)
+{
+	if (ok) return;
+	printf("FAIL: %s:%d: %s\n", file, line, what);
+	++test_failures;
+} // end check
+
+
+int test_done(void)
+{
+	printf("%s\n", test_failures ? "FAILED" : "ok");
+	return test_failures ? 1 : 0;
+} // end test_done
+
+
+static void sim_alarm(int sig)
+{
+	static const char msg[] = "FAIL: test hung (60 s alarm)\n";
+
+	write(1, msg, sizeof(msg) - 1);
+	_exit(1);
+} // end sim_alarm
+
+
+//******************************************************************************
+//	interrupts
+//
+static void sim_isr(void (*isr)(void))
+{
+	unsigned sr = SR;
+	uint64_t start = sim_now;
+
+	if (!isr) sim_fail("interrupt with no ISR linked");
+	sim_sr_exit = sr;
+	SR = sr & ~(GIE | CPUOFF);
+	++sim_in_isr;
+	++isr_count;
+	isr();
+	--sim_in_isr;
+	SR = sim_sr_exit;
+	if (sim_now - start > isr_longest) isr_longest = sim_now - start;
+} // end sim_isr
+
+
+void sim_gie(void)
+{
+	unsigned stat;
+
+	while ((SR & GIE) && !sim_in_isr)
+	{
+		stat = UCB0STAT.v & UCB0I2CIE.v & (UCNACKIFG | UCSTPIFG | UCSTTIFG
+			| UCALIFG);
+		if ((TACCTL1.v & CCIE) && (TACCTL1.v & CCIFG)) sim_isr(TIMERA1_ISR);
+		else if ((IFG2.v & IE2.v & UCA0RXIFG) || stat) sim_isr(USCIAB0RX_ISR);
+		else if (IFG2.v & IE2.v & (UCA0TXIFG | UCB0TXIFG | UCB0RXIFG))
+			sim_isr(USCIAB0TX_ISR);
+		else if (P1IFG.v & P1IE.v) sim_isr(PORT1_ISR);
+		else break;
+	}
+} // end sim_gie
+
+
+//******************************************************************************
+//	USCI_A0 UART
+//
+uint64_t sim_uart_byte(void)
+{
+	uint32_t n8 = ((UCA0BR1.v << 8) | UCA0BR0.v) * 8 + ((UCA0MCTL.v >> 1) & 7);
+
+	return (10 * n8 + 4) / 8;			// 10 bit times
+} // end sim_uart_byte
+
+
+static void uart_tx_load(void)
+{
+	uart_tx_sh = UCA0TXBUF.v;
+	uart_tx_full = 0;
+	uart_tx_at = sim_now + sim_uart_byte();
+	IFG2.v |= UCA0TXIFG;				// buffer free again
+} // end uart_tx_load
+
+
+static void uart_received(uint8_t c)
+{
+	if (IFG2.v & UCA0RXIFG)
+	{
+		UCA0STAT.v |= UCOE;				// last byte not read
+		++uart_overruns;
+	}
+	UCA0RXBUF.v = c;
+	IFG2.v |= UCA0RXIFG;
+} // end uart_received
+
+
+static void uart_step(void)
+{
+	if (UCA0CTL1.v & UCSWRST) return;
+	if (uart_tx_at && (sim_now >= uart_tx_at))
+	{
+		uart_tx_at = 0;
+		if (sim_uart_loopback) uart_received(uart_tx_sh);
+		else uart_out.push_back(uart_tx_sh);
+		if (uart_tx_full) uart_tx_load();
+	}
+	if (uart_rx_at && (sim_now >= uart_rx_at))
+	{
+		uart_received(uart_rx_line.front());
+		uart_rx_line.pop_front();
+		uart_rx_at = uart_rx_line.empty() ? 0 : uart_rx_at + sim_uart_byte();
+	}
+} // end uart_step
+
+
+void sim_uart_rx(const uint8_t* data, size_t count)
+{
+	if (count && uart_rx_line.empty()) uart_rx_at = sim_now + sim_uart_byte();
+	uart_rx_line.insert(uart_rx_line.end(), data, data + count);
+} // end sim_uart_rx
+
+
+static void uca0ctl1_wr(uint8_t was, uint8_t now)
+{
+	if (!(now & UCSWRST)) return;
+	IE2.v &= ~(UCA0RXIE | UCA0TXIE);	// (reset by UCSWRST)
+	IFG2.v = (IFG2.v & ~UCA0RXIFG) | UCA0TXIFG;
+	UCA0STAT.v = 0;
+	uart_tx_at = 0;
+	uart_tx_full = 0;
+} // end uca0ctl1_wr
+
+
+static void uca0txbuf_wr(uint8_t was, uint8_t now)
+{
+	IFG2.v &= ~UCA0TXIFG;
+	uart_tx_full = 1;
+	if (!uart_tx_at) uart_tx_load();	// shift register free
+} // end uca0txbuf_wr
+
+
+static void uca0rxbuf_rd(void)
+{
+	IFG2.v &= ~UCA0RXIFG;
+	UCA0STAT.v &= ~UCOE;
+} // end uca0rxbuf_rd
+
+
+static void uca0stat_rd(void)
+{
+	if (uart_tx_at) UCA0STAT.v |= UCBUSY;
+	else UCA0STAT.v &= ~UCBUSY;
+} // end uca0stat_rd
+
+
+//******************************************************************************
+//	USCI_B0 I2C master
+//
+static uint64_t i2c_clocks(int n)
+{
+	uint32_t div = (UCB0BR1.v << 8) | UCB0BR0.v;
+
+	return (uint64_t)n * (div ? div : 1);
+} // end i2c_clocks
+
+
+static void i2c_log(const char* fmt, int value)
+{
+	char s[16];
+
+	snprintf(s, sizeof(s), fmt, value);
+	i2c_trace += s;
+} // end i2c_log
+
+
+static void i2c_start(void)				// (repeated) start + address
+{
+	i2c_log(i2c_state == I_IDLE ? "S " : "Sr ", 0);
+	i2c_read = !(UCB0CTL1.v & UCTR);
+	i2c_nacked = 0;
+	i2c_tx_full = 0;
+	i2c_state = I_ADDR;
+	i2c_at = sim_now + i2c_clocks(10);
+	if (!i2c_read) IFG2.v |= UCB0TXIFG;	// first byte can be written
+} // end i2c_start
+
+
+static void i2c_decide(void)			// after address or byte
+{
+	if (!i2c_read && i2c_tx_full)
+	{
+		i2c_tx_sh = UCB0TXBUF.v;
+		i2c_tx_full = 0;
+		IFG2.v |= UCB0TXIFG;
+		i2c_state = I_TX;
+		i2c_at = sim_now + i2c_clocks(9);
+		return;
+	}
+	if (UCB0CTL1.v & UCTXSTP)
+	{
+		i2c_state = I_STOP;
+		i2c_at = sim_now + i2c_clocks(1);
+		return;
+	}
+	if (UCB0CTL1.v & UCTXSTT)
+	{
+		i2c_start();
+		return;
+	}
+	if (i2c_read)
+	{
+		i2c_state = I_RX;
+		i2c_at = sim_now + i2c_clocks(9);
+		return;
+	}
+	i2c_state = I_HOLD;					// SCL held - wait for data or stop
+} // end i2c_decide
+
+
+static void i2c_nack(void)
+{
+	i2c_log("NACK ", 0);
+	UCB0STAT.v |= UCNACKIFG;
+	i2c_nacked = 1;
+	i2c_state = I_HOLD;
+} // end i2c_nack
+
+
+static void i2c_step(void)
+{
+	int again;
+
+	if (UCB0CTL1.v & UCSWRST) return;
+	do
+	{
+		again = 0;
+		switch (i2c_state)
+		{
+			case I_IDLE:
+				if (UCB0CTL1.v & UCTXSTT) i2c_start();
+				break;
+
+			case I_ADDR:
+				if (sim_now < i2c_at) break;
+				++i2c_bytes;
+				i2c_slave = i2c_slaves[UCB0I2CSA.v & 0x7f];
+				i2c_log("%02x ", UCB0I2CSA.v & 0x7f);
+				i2c_log(i2c_read ? "R " : "W ", 0);
+				UCB0CTL1.v &= ~UCTXSTT;
+				if (!i2c_slave || !i2c_slave->start(i2c_read))
+				{
+					i2c_nack();
+					break;
+				}
+				if (i2c_read)
+				{
+					i2c_state = I_RX;
+					i2c_at = sim_now + i2c_clocks(9);
+				}
+				else i2c_decide();
+				again = 1;
+				break;
+
+			case I_TX:
+				if ((sim_now < i2c_at) || i2c_slave->hold(0)) break;
+				++i2c_bytes;
+				i2c_log("%02x ", i2c_tx_sh);
+				if (!i2c_slave->write(i2c_tx_sh))
+				{
+					i2c_nack();
+					break;
+				}
+				i2c_decide();
+				again = 1;
+				break;
+
+			case I_RX:
+				if ((sim_now < i2c_at) || i2c_slave->hold(0)) break;
+				if (IFG2.v & UCB0RXIFG) break;	// last byte not read - stall
+				++i2c_bytes;
+				UCB0RXBUF.v = i2c_slave->read();
+				i2c_log("%02x ", UCB0RXBUF.v);
+				IFG2.v |= UCB0RXIFG;
+				if (UCB0CTL1.v & (UCTXSTP | UCTXSTT))	// NACK this byte
+				{
+					if (UCB0CTL1.v & UCTXSTP)
+					{
+						i2c_state = I_STOP;
+						i2c_at = sim_now + i2c_clocks(1);
+					}
+					else i2c_start();
+					break;
+				}
+				i2c_at = sim_now + i2c_clocks(9);
+				break;
+
+			case I_HOLD:
+				if (!i2c_read && i2c_tx_full && !i2c_nacked)
+				{
+					i2c_decide();
+					again = 1;
+				}
+				else if (UCB0CTL1.v & UCTXSTP)
+				{
+					i2c_state = I_STOP;
+					i2c_at = sim_now + i2c_clocks(1);
+				}
+				else if (UCB0CTL1.v & UCTXSTT) i2c_start();
+				break;
+
+			case I_STOP:
+				if (sim_now < i2c_at) break;
+				if (i2c_slave && i2c_slave->hold(1)) break;
+				if (i2c_slave) i2c_slave->stop();
+				i2c_log("P ", 0);
+				i2c_slave = 0;
+				UCB0CTL1.v &= ~UCTXSTP;
+				i2c_state = I_IDLE;
+				again = (UCB0CTL1.v & UCTXSTT) != 0;
+				break;
+		}
+	} while (again);
+} // end i2c_step
+
+
+static void ucb0ctl1_wr(uint8_t was, uint8_t now)
+{
+	if (now & UCSWRST)
+	{
+		if ((i2c_state != I_IDLE) && !(was & UCSWRST)) i2c_log("reset ", 0);
+		UCB0CTL1.v &= ~(UCTXSTT | UCTXSTP);
+		IE2.v &= ~(UCB0RXIE | UCB0TXIE);
+		IFG2.v &= ~(UCB0RXIFG | UCB0TXIFG);
+		UCB0I2CIE.v = 0;
+		UCB0STAT.v = 0;
+		i2c_state = I_IDLE;
+		i2c_slave = 0;
+		i2c_tx_full = 0;
+		return;
+	}
+	if ((i2c_state == I_IDLE) && (now & UCTXSTT) && !(was & UCTXSTT))
+	{
+		i2c_start();
+	}
+} // end ucb0ctl1_wr
+
+
+static void ucb0txbuf_wr(uint8_t was, uint8_t now)
+{
+	IFG2.v &= ~UCB0TXIFG;
+	i2c_tx_full = 1;
+} // end ucb0txbuf_wr
+
+
+static void ucb0rxbuf_rd(void)
+{
+	IFG2.v &= ~UCB0RXIFG;
+} // end ucb0rxbuf_rd
+
+
+static void ucb0stat_rd(void)
+{
+	if (i2c_state != I_IDLE) UCB0STAT.v |= UCBBUSY;
+	else UCB0STAT.v &= ~UCBBUSY;
+} // end ucb0stat_rd
+
+
+void sim_i2c_attach(uint8_t addr, I2cSlave* slave)
+{
+	i2c_slaves[addr & 0x7f] = slave;
+} // end sim_i2c_attach
+
+
+void sim_i2c_detach(uint8_t addr)
+{
+	i2c_slaves[addr & 0x7f] = 0;
+} // end sim_i2c_detach
+
+
+//******************************************************************************
+//	Timer A, port 1
+//
+static void taiv_rd(void)
+{
+	TAIV.v = 0;
+	if (TACCTL1.v & CCIFG)
+	{
+		TACCTL1.v &= ~CCIFG;
+		TAIV.v = TAIV_TACCR1;
+	}
+} // end taiv_rd
+
+
+void sim_p1_pin(uint8_t bit, int high)
+{
+	uint8_t was = P1IN.v & bit;
+
+	if (high) P1IN.v |= bit;
+	else P1IN.v &= ~bit;
+	if (was == (P1IN.v & bit)) return;
+	if (high == !(P1IES.v & bit)) P1IFG.v |= bit;	// edge selected
+	sim_gie();
+} // end sim_p1_pin
+
+
+//******************************************************************************
+//	time
+//
+static void sim_step(void)
+{
+	int i;
+
+	sim_now += 8;						// one Timer A tick (SMCLK/8)
+	if (TACTL.v & (MC_1 | MC_2))
+	{
+		++TAR.v;
+		if (TAR.v == TACCR1.v) TACCTL1.v |= CCIFG;
+	}
+	uart_step();
+	i2c_step();
+	for (i = 0; i < 128; ++i)
+	{
+		if (i2c_slaves[i]) i2c_slaves[i]->tick(sim_now);
+	}
+	sim_gie();
+} // end sim_step
+
+
+static void tar_rd(void)
+{
+	sim_step();							// reading TAR takes time
+} // end tar_rd
+
+
+static void irq_wr(uint8_t was, uint8_t now)
+{
+	sim_gie();							// (newly enabled interrupt runs now)
+} // end irq_wr
+
+
+static void tacctl1_wr(uint16_t was, uint16_t now)
+{
+	sim_gie();
+} // end tacctl1_wr
+
+
+void sim_sleep(void)
+{
+	uint64_t limit = sim_now + (uint64_t)mclk_kHz * 10000;	// 10 s
+
+	while (SR & CPUOFF)
+	{
+		if (!(SR & GIE)) sim_fail("sleep with interrupts off");
+		if (sim_now > limit) sim_fail("asleep 10 s with no wake-up");
+		sim_step();
+	}
+} // end sim_sleep
+
+
+void sim_run(uint64_t cycles)
+{
+	uint64_t end = sim_now + cycles;
+
+	while (sim_now < end) sim_step();
+} // end sim_run
+
+
+uint64_t sim_cycles(void)
+{
+	return sim_now;
+} // end sim_cycles
+
+
+double sim_ms(uint64_t cycles)
+{
+	return cycles / (double)(mclk_kHz ? mclk_kHz : 1);
+} // end sim_ms
+
+
+//******************************************************************************
+//	P4.7 (E) strobes the display (data on P2, A0 = P3.0, RW = P3.3)
+//
+static void p4out_wr(uint8_t was, uint8_t now)
+{
+	int a0 = P3OUT.v & LCD_A0;
+	int rw = P3OUT.v & LCD_RW;
+
+	if (!(was & LCD_E) && (now & LCD_E))
+	{
+		++lcd_model.strobes;
+		if (rw && a0) P2IN.v = lcd_model.read_data();
+	}
+	if ((was & LCD_E) && !(now & LCD_E) && !rw)
+	{
+		if (a0) lcd_model.write_data(P2OUT.v);
+		else lcd_model.write_cmd(P2OUT.v);
+	}
+} // end p4out_wr
+
+
+//******************************************************************************
+//	reset everything (MCLK = SMCLK = kHz, as RBX430_init sets it)
+//
+void sim_init(uint16_t kHz)
+{
+	mclk_kHz = kHz;
+	i2c_fSCL = kHz / I2C_FSCL;
+	sim_now = 0;
+	sim_in_isr = 0;
+	SR = 0;
+	TAR.v = 0;
+	TACTL.v = 0;
+	TACCTL1.v = 0;
+	IE2.v = 0;
+	IFG2.v = UCA0TXIFG;
+	P1IN.v = P1IFG.v = P1IE.v = P1IES.v = 0;
+
+	uart_out.clear();
+	uart_rx_line.clear();
+	uart_rx_at = uart_tx_at = 0;
+	uart_tx_full = 0;
+	sim_uart_loopback = 0;
+	uart_overruns = 0;
+
+	for (int i = 0; i < 128; ++i) i2c_slaves[i] = 0;
+	i2c_slave = 0;
+	i2c_state = I_IDLE;
+	i2c_tx_full = 0;
+	i2c_trace.clear();
+	i2c_bytes = 0;
+	isr_count = 0;
+	isr_longest = 0;
+
+	lcd_model.reset();
+
+	TAR.rd = tar_rd;
+	TAIV.rd = taiv_rd;
+	TACCTL1.wr = tacctl1_wr;
+	IE2.wr = irq_wr;
+	IFG2.wr = irq_wr;
+	P1IE.wr = irq_wr;
+	UCB0I2CIE.wr = irq_wr;
+	UCA0CTL1.wr = uca0ctl1_wr;
+	UCA0TXBUF.wr = uca0txbuf_wr;
+	UCA0RXBUF.rd = uca0rxbuf_rd;
+	UCA0STAT.rd = uca0stat_rd;
+	UCB0CTL1.wr = ucb0ctl1_wr;
+	UCB0TXBUF.wr = ucb0txbuf_wr;
+	UCB0RXBUF.rd = ucb0rxbuf_rd;
+	UCB0STAT.rd = ucb0stat_rd;
+	P4OUT.wr = p4out_wr;
+
+	signal(SIGALRM, sim_alarm);
+	alarm(60);
+} // end sim_init
@@ -0,0 +1,85 @@
+//	sim.h - host models behind the register model (msp430x22x4.h)
+//******************************************************************************
+//******************************************************************************
+//	Description:	Time, interrupts and the peripherals the drivers talk to
+//
+//	Time is counted in MCLK cycles (SMCLK = MCLK).  The models run only
+//	when the code under test lets time pass:
+//
+//		sim_run(cycles)		the test waits
+//		sleep (LPM0)		until an ISR clears CPUOFF
+//		read of TAR			one Timer A tick (8 cycles) per read
+//
+//	Each step moves Timer A (SMCLK/8, continuous), shifts UART and I2C
+//	bits and ticks the I2C slaves, then runs pending interrupts if GIE is
+//	set (priority TIMERA1, USCIAB0RX, USCIAB0TX, PORT1).  Code that spins
+//	on a RAM variable set by an ISR never lets time pass and hangs - each
+//	test runs under a 60 second alarm.
+//
+//	USCI_A0		bytes written to UCA0TXBUF go out at the baud rate set in
+//				UCA0BR0/1 and UCA0MCTL (10 bit times each) into uart_out, or
+//				back into the receiver (sim_uart_loopback).  sim_uart_rx
+//				queues bytes to arrive back to back.  A byte that arrives
+//				with UCA0RXIFG still set overruns (UCOE, uart_overruns).
+//	USCI_B0		I2C master: start + address, data bytes and stop take 10,
+//				9 and 1 SCL clocks (UCB0BR0/1 SMCLK cycles).  A slave that
+//				holds SCL (I2cSlave::hold) stalls the bus.  i2c_trace logs
+//				the bus ("S 53 W 2d 08 Sr R 00 P").
+//	ST7529		lcd_model, driven from P2, P3.0 (A0), P3.3 (RW) and P4.7 (E)
+//******************************************************************************
+//
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "msp430x22x4.h"
+#include "st7529.h"
+
+//	I2C slave (attached at a 7 bit address)
+struct I2cSlave
+{
+	virtual ~I2cSlave() {}
+	virtual int start(int read) { return 1; }	// 1 = address acknowledged
+	virtual int write(uint8_t byte) { return 1; }	// 1 = acknowledged
+	virtual uint8_t read(void) { return 0xff; }
+	virtual void stop(void) {}
+	virtual int hold(int stop) { return 0; }	// 1 = SCL held (stop: at P)
+	virtual void tick(uint64_t cycles) {}		// time is now cycles
+};
+
+//	sim prototypes
+void sim_init(uint16_t kHz);			// reset models, MCLK (kHz)
+void sim_run(uint64_t cycles);			// let time pass (ISRs run)
+uint64_t sim_cycles(void);				// MCLK cycles since sim_init
+double sim_ms(uint64_t cycles);			// cycles to ms
+void sim_fail(const char* what);		// report and exit 1
+
+void sim_p1_pin(uint8_t bit, int high);	// drive a P1 input (edges set P1IFG)
+
+void sim_uart_rx(const uint8_t* data, size_t count);	// bytes to receive
+uint64_t sim_uart_byte(void);			// cycles per UART byte
+
+void sim_i2c_attach(uint8_t addr, I2cSlave* slave);
+void sim_i2c_detach(uint8_t addr);
+
+extern St7529 lcd_model;				// display
+extern std::vector<uint8_t> uart_out;	// bytes sent by USCI_A0
+extern int sim_uart_loopback;			// 1 = TXD wired to RXD
+extern long uart_overruns;				// bytes lost in UCA0RXBUF
+extern std::string i2c_trace;			// bus log (sim_init clears)
+extern long i2c_bytes;					// address and data bytes on the bus
+extern long isr_count;					// interrupts served
+extern uint64_t isr_longest;			// longest ISR (cycles - time only
+										// 	passes in an ISR that reads TAR)
+
+//	test report helpers
+extern int test_failures;
+#define CHECK(cond)		check((cond), #cond, __FILE__, __LINE__)
+void check(int ok, const char* what, const char* file, int line);
+int test_done(void);					// summary line, exit status
+
+#endif /*SIM_H_*/
@@ -0,0 +1,192 @@
+//	slaves.h - I2C slave models for the driver tests
+//******************************************************************************
+//******************************************************************************
+//	Description:	Slaves attached with sim_i2c_attach (sim.h)
+//
+//	MemSlave	register file / memory: the first abytes bytes written
+//				set the address pointer (high byte first), later bytes
+//				are written there and reads come from there - the pointer
+//				counts up and wraps at size.  nack_after makes the slave
+//				NACK data bytes once that many were written; stuck holds
+//				SCL low (stuck_at_stop: only at the stop condition).
+//	Adxl345		accelerometer registers the driver uses.  Once POWER_CTL
+//				measure is set, a sample is taken every 1/ODR (BW_RATE:
+//				3200Hz >> (15 - rate)) into a 32 entry stream FIFO - when
+//				full, the oldest is overwritten (overwritten counts them).
+//				Reading DATAZ1 pops an entry.  INT1 (P1.4) follows the
+//				watermark (FIFO_CTL) if enabled.  Sample n is x = n,
+//				y = -n, z = 256, or wave(n, axis) if set.
+//******************************************************************************
+//
+#ifndef SLAVES_H_
+#define SLAVES_H_
+
+#include <string.h>
+#include <vector>
+
+#include "sim.h"
+
+struct MemSlave : I2cSlave
+{
+	std::vector<uint8_t> mem;
+	unsigned size;						// bytes (power of 2)
+	int abytes;							// address bytes
+	unsigned ptr;						// address pointer
+	int nwritten;						// bytes written since start
+	int nack_after;						// NACK data after this many (-1 none)
+	int stuck, stuck_at_stop;
+	long starts, stops;
+
+	MemSlave(int address_bytes, unsigned bytes) : mem(bytes, 0),
+		size(bytes), abytes(address_bytes), ptr(0), nwritten(0),
+		nack_after(-1), stuck(0), stuck_at_stop(0),
+		starts(0), stops(0) {}
+
+	int start(int read)
+	{
+		++starts;
+		nwritten = 0;
+		return 1;
+	}
+
+	int write(uint8_t byte)
+	{
+		int n = nwritten++;
+
+		if (n < abytes)					// address pointer
+		{
+			ptr = (n == 0) ? byte : ((ptr << 8) | byte);
+			ptr &= size - 1;
+			return 1;
+		}
+		if ((nack_after >= 0) && (n - abytes >= nack_after)) return 0;
+		mem[ptr] = byte;
+		ptr = (ptr + 1) & (size - 1);
+		return 1;
+	}
+
+	uint8_t read(void)
+	{
+		uint8_t byte = mem[ptr];
+
+		ptr = (ptr + 1) & (size - 1);
+		return byte;
+	}
+
+	int hold(int at_stop)
+	{
+		return stuck || (stuck_at_stop && at_stop);
+	}
+
+	void stop(void) { ++stops; }
+};
+
+struct Adxl345 : I2cSlave
+{
+	uint8_t reg[64];
+	int ptr, nwritten;
+	uint16_t fifo[32];					// sample numbers
+	int count, first;
+	uint16_t n;							// next sample number
+	uint64_t next_at;					// next sample (cycles)
+	uint32_t kHz;						// MCLK
+	long overwritten;
+	int int1;
+	int16_t (*wave)(uint16_t n, int axis);	// sample n, axis 0-2 (or 0)
+
+	Adxl345(uint32_t mclk_kHz) : ptr(0), nwritten(0), count(0), first(0),
+		n(0), next_at(0), kHz(mclk_kHz), overwritten(0), int1(0), wave(0)
+	{
+		memset(reg, 0, sizeof(reg));
+		reg[0x00] = 0xe5;				// DEVID
+		reg[0x2c] = 0x0a;				// BW_RATE 100Hz
+	}
+
+	uint64_t period(void)				// cycles per sample
+	{
+		return (uint64_t)kHz * 1000 / (3200 >> (15 - (reg[0x2c] & 0x0f)));
+	}
+
+	void load(void)						// oldest entry to DATAX0-DATAZ1
+	{
+		uint16_t s = fifo[first];
+		int16_t v[3] = { (int16_t)s, (int16_t)-s, 256 };
+
+		for (int i = 0; i < 3; ++i)
+		{
+			if (wave) v[i] = wave(s, i);
+			reg[0x32 + i * 2] = v[i] & 0xff;
+			reg[0x33 + i * 2] = (uint16_t)v[i] >> 8;
+		}
+	}
+
+	void pin(void)						// INT1 = watermark
+	{
+		int level = (reg[0x2e] & 0x02) && (count >= (reg[0x38] & 0x1f));
+
+		if (level != int1) sim_p1_pin(0x10, int1 = level);
+	}
+
+	int start(int read)
+	{
+		nwritten = 0;
+		return 1;
+	}
+
+	int write(uint8_t byte)
+	{
+		if (nwritten++ == 0)
+		{
+			ptr = byte & 0x3f;
+			return 1;
+		}
+		if (ptr == 0x38)				// FIFO_CTL - bypass empties FIFO
+		{
+			if (!(byte & 0xc0)) count = 0;
+		}
+		if ((ptr == 0x2d) && (byte & 0x08) && !(reg[0x2d] & 0x08))
+		{
+			next_at = sim_cycles() + period();	// measure from now
+		}
+		reg[ptr] = byte;
+		ptr = (ptr + 1) & 0x3f;
+		pin();
+		return 1;
+	}
+
+	uint8_t read(void)
+	{
+		uint8_t byte;
+
+		if (ptr == 0x39) reg[0x39] = count;	// FIFO_STATUS
+		if ((ptr >= 0x32) && (ptr <= 0x37) && count) load();
+		byte = reg[ptr];
+		if ((ptr == 0x37) && count)		// DATAZ1 - pop
+		{
+			first = (first + 1) & 31;
+			--count;
+			pin();
+		}
+		ptr = (ptr + 1) & 0x3f;
+		return byte;
+	}
+
+	void tick(uint64_t now)
+	{
+		if (!(reg[0x2d] & 0x08)) return;	// standby
+		while (now >= next_at)
+		{
+			if (count == 32)			// stream - overwrite oldest
+			{
+				first = (first + 1) & 31;
+				--count;
+				++overwritten;
+			}
+			fifo[(first + count++) & 31] = n++;
+			next_at += period();
+		}
+		pin();
+	}
+};
+
+#endif /*SLAVES_H_*/
@@ -0,0 +1,165 @@
+//	st7529.h - host model of the ST7529 LCD controller (YM160160C)
+//******************************************************************************
+//******************************************************************************
+//	Description:	Display RAM and the commands the RBX430_lcd.c driver uses,
+//					driven from the port pins (sim.cpp):
+//
+//		P2OUT/P2IN	data bus		P3.0 A0 (1 = data)
+//		P4.7 E		strobe			P3.3 RW (1 = read)
+//
+//	A write is latched on the falling edge of E, a read is put on P2IN on
+//	the rising edge.  RAM is 160 lines of 54 words (108 bytes, 2B3P - 3
+//	pixels per word, 0 bits = pixel on).  Column and line windows wrap
+//	like the controller; RMW (0xe0/0xee) reads without moving the column.
+//	The scroll start (0xab, 4 line blocks) only changes what is shown.
+//
+//	Counts:	strobes (E pulses), cmds, writes, reads - reset_counts()
+//******************************************************************************
+//
+#ifndef ST7529_H_
+#define ST7529_H_
+
+#include <stdint.h>
+#include <string.h>
+
+struct St7529
+{
+	uint8_t ram[160][108];				// display RAM (line, byte)
+	int xs, xe, ys, ye;					// window (words, lines)
+	int cx, cy, half;					// address counter
+	int cmd, nparam;					// last command
+	int mode;							// 0 none, 1 write, 2 read, 3 RMW
+	int rmw_cx, rmw_cy, rd_half;
+	int dummy;							// next read is a dummy read
+	int inverse, scroll;				// display only
+	long strobes, cmds, writes, reads;
+
+	St7529() { reset(); }
+
+	void reset(void)
+	{
+		memset(ram, 0, sizeof(ram));
+		xs = 0; xe = 0x35; ys = 0; ye = 0x9f;
+		cx = cy = half = 0;
+		cmd = -1; nparam = 0; mode = 0;
+		rmw_cx = rmw_cy = rd_half = 0; dummy = 0;
+		inverse = scroll = 0;
+		reset_counts();
+	}
+
+	void reset_counts(void) { strobes = cmds = writes = reads = 0; }
+
+	uint8_t& at(void) { return ram[cy % 160][(cx * 2 + half) % 108]; }
+
+	void next(void)						// advance address counter
+	{
+		if (++half < 2) return;
+		half = 0;
+		if (++cx <= xe) return;
+		cx = xs;
+		if (++cy > ye) cy = ys;
+	}
+
+	void write_cmd(uint8_t c)
+	{
+		++cmds;
+		cmd = c;
+		nparam = 0;
+		switch (c)
+		{
+			case 0x5c: mode = 1; cx = xs; cy = ys; half = 0; break;	// RAMWR
+			case 0x5d: mode = 2; cx = xs; cy = ys; half = 0; dummy = 1;	// RAMRD
+				break;
+			case 0xe0: mode = 3; rmw_cx = cx; rmw_cy = cy;	// RMWIN
+				half = rd_half = 0; dummy = 1; break;
+			case 0xee: if (mode == 3) { cx = rmw_cx; cy = rmw_cy; half = 0; }
+				mode = 0; break;
+			case 0xa6: inverse = 0; break;
+			case 0xa7: inverse = 1; break;
+			default: if (mode != 3) mode = 0; break;
+		}
+	}
+
+	void write_data(uint8_t d)
+	{
+		++writes;
+		if ((mode == 1) || (mode == 3))
+		{
+			at() = d;
+			next();
+			if (mode == 3) dummy = 1, rd_half = 0;	// read again after write
+			return;
+		}
+		++nparam;
+		switch (cmd)
+		{
+			case 0x75:					// LASET
+				if (nparam == 1) ys = cy = d;
+				if (nparam == 2) ye = d;
+				break;
+			case 0x15:					// CASET
+				if (nparam == 1) xs = cx = d;
+				if (nparam == 2) xe = d;
+				half = 0;
+				break;
+			case 0xab:					// scroll start
+				scroll = d;
+				break;
+		}
+	}
+
+	uint8_t read_data(void)
+	{
+		++reads;
+		if (dummy)
+		{
+			dummy = 0;
+			return 0xaa;
+		}
+		if (mode == 2)
+		{
+			uint8_t d = at();
+			next();
+			return d;
+		}
+		if (mode == 3)					// RMW: read does not move
+		{
+			uint8_t d = ram[cy % 160][(cx * 2 + rd_half) % 108];
+			rd_half ^= 1;
+			return d;
+		}
+		return 0x55;
+	}
+
+	uint16_t word(int col, int line)
+	{
+		return (ram[line][col * 2] << 8) | ram[line][col * 2 + 1];
+	}
+
+	//	pixel at x,y in driver coordinates (0,0 lower left) of RAM line y
+	int pixel(int x, int y)
+	{
+		int c = 159 - x;
+		static const uint16_t field[3] = { 0x001f, 0x07c0, 0xf800 };
+
+		return (word(c / 3, y) & field[c % 3]) == 0;
+	}
+
+	//	pixel as shown (scroll start in 4 line blocks, inverse)
+	int shown(int x, int y)
+	{
+		return pixel(x, (y + scroll * 4) % 160) ^ inverse;
+	}
+
+	//	RAM bytes equal, ignoring the unused bit 5 of the low byte
+	int same(const uint8_t other[160][108])
+	{
+		for (int y = 0; y < 160; ++y)
+			for (int b = 0; b < 108; ++b)
+				if ((ram[y][b] ^ other[y][b]) & ((b & 1) ? 0xdf : 0xff))
+					return 0;
+		return 1;
+	}
+};
+
+#endif /*ST7529_H_*/
@@ -0,0 +1,117 @@
+//	test_adxl345.cpp - RBX430_adxl345.c against the ADXL345 model
+//******************************************************************************
+//******************************************************************************
+//	The model's sample n reads x = n, so a gap in x is a lost sample.
+//
+#include "sim.h"
+#include "slaves.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+#include "RBX430_uart.h"
+#include "RBX430_adxl345.h"
+
+static Adxl345* xl;
+static long samples, gaps;
+static int16 last_x;
+
+
+void PORT1_ISR(void)
+{
+	if (P1IFG & ADXL345_INT) xl_port1_isr();
+} // end PORT1_ISR
+
+
+static void xl_setup(void)
+{
+	static Adxl345* model;
+	uint8 error;
+
+	delete model;
+	sim_init(8000);
+	model = xl = new Adxl345(8000);
+	sim_i2c_attach(XL_ADDR, xl);
+	uart_init(115200);
+	__enable_interrupt();
+	i2c_init(100);
+	error = xl_init(XL_RATE_100HZ);
+	CHECK(error == 0);
+	samples = gaps = 0;
+	last_x = -1;
+} // end xl_setup
+
+
+//	main loop: take what is waiting, every 5 ms for ms
+static void xl_loop(int ms)
+{
+	XL_SAMPLE s;
+	int t;
+
+	for (t = 0; t < ms; t += 5)
+	{
+		if (t) sim_run(5 * 8000);
+		while (xl_read(&s))
+		{
+			if (s.x != (int16)(last_x + 1)) ++gaps;
+			if ((s.y != -s.x) || (s.z != 256)) ++gaps;
+			last_x = s.x;
+			++samples;
+		}
+	}
+} // end xl_loop
+
+
+//******************************************************************************
+//	steady reading: every sample, (XL_WATERMARK + 1) / XL_WATERMARK reads
+//
+static void test_steady(void)
+{
+	xl_setup();
+	xl_loop(2000);
+	CHECK(gaps == 0);
+	CHECK((samples >= 195) && (samples <= 200));
+	CHECK(xl_lost == 0);
+	CHECK(xl->overwritten == 0);
+	printf("\n  2 s at 100 Hz: %ld samples, %ld gaps, %.2f I2C reads per"
+		" sample\n", samples, gaps, (double)xl_reads / samples);
+} // end test_steady
+
+
+//******************************************************************************
+//	main loop stalls: the ring fills, the rest wait in the FIFO - nothing
+//	is lost up to XL_RING_SIZE + 32 - XL_WATERMARK samples (~350 ms)
+//
+static void test_stall(int ms)
+{
+	long before;
+
+	xl_setup();
+	xl_loop(200);
+	before = samples;
+	sim_run((uint64_t)ms * 8000);		// not reading
+	xl_loop(1000);
+	printf("  stall %3d ms: %ld samples after, %ld gaps, FIFO overwrote"
+		" %ld, xl_lost %u\n", ms, samples - before, gaps, xl->overwritten,
+		(unsigned)xl_lost);
+	if (ms <= 350)
+	{
+		CHECK(gaps == 0);
+		CHECK(xl->overwritten == 0);
+	}
+	else
+	{
+		CHECK(xl->overwritten > 0);
+		CHECK(xl_lost > 0);
+	}
+} // end test_stall
+
+
+int main(void)
+{
+	test_steady();
+	test_stall(100);
+	test_stall(300);
+	test_stall(350);
+	test_stall(400);
+	test_stall(1000);
+	return test_done();
+} // end main
@@ -0,0 +1,210 @@
+//	test_canvas.cpp - lcd_canvas.c save/restore (1 bit runs) and the FRAM
+//	store on an FM24CL64B model
+//******************************************************************************
+//******************************************************************************
+//	A stroke is a 40 step random walk drawn with lcd_point (DOUBLE_PEN),
+//	as the sketch draws; sketches are seeded, so sizes repeat run to run.
+//
+#include <vector>
+
+#include "sim.h"
+#include "slaves.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+#include "RBX430_uart.h"
+#include "RBX430_lcd.h"
+#include "RBX430_fram.h"
+
+#define BYU1_LOGO	1
+#include "lcd_byu_images.c"
+#include "lcd_etch-a-sketch_images.c"
+
+static std::vector<uint8_t> store;		// RAM canvas store
+static size_t store_at;
+static MemSlave* fram;
+static uint32_t seed;
+static uint8_t drawn[160][108];
+
+
+static uint8 store_put(uint8 byte)
+{
+	store.push_back(byte);
+	return 0;
+} // end store_put
+
+
+static int16 store_get(void)
+{
+	return (store_at < store.size()) ? store[store_at++] : -1;
+} // end store_get
+
+
+static int walk(int n)					// 0 to n-1
+{
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 16) % n;
+} // end walk
+
+
+static void canvas_setup(void)
+{
+	delete fram;
+	sim_init(8000);
+	fram = new MemSlave(2, FRAM_SIZE);
+	memset(fram->mem.data(), 0xff, FRAM_SIZE);	// new part
+	sim_i2c_attach(FRAM_ADDR, fram);
+	uart_init(115200);
+	__enable_interrupt();
+	i2c_init(400);
+	lcd_init();
+	lcd_clear();
+} // end canvas_setup
+
+
+static void sketch(int strokes)
+{
+	int i, j, x, y;
+
+	seed = strokes;
+	for (i = 0; i < strokes; ++i)
+	{
+		x = walk(156) + 2;
+		y = walk(156) + 2;
+		for (j = 0; j < 40; ++j)
+		{
+			x += walk(3) - 1;
+			y += walk(3) - 1;
+			lcd_point(x, y, DOUBLE_PEN);
+		}
+	}
+	return;
+} // end sketch
+
+
+//	display RAM at 1 bit per pixel (on = darker than half gray) is what
+//	was drawn at 1 bit - restore writes pixels fully on or off
+static int same_1bit(void)
+{
+	static const uint16_t half[3] = { 0x8000, 0x0400, 0x0010 };
+	uint16_t was, now;
+
+	for (int line = 0; line < 160; ++line)
+	{
+		for (int c = 0; c < 54; ++c)
+		{
+			was = (drawn[line][c * 2] << 8) | drawn[line][c * 2 + 1];
+			now = lcd_model.word(c, line);
+			for (int k = 0; k < 3; ++k)
+				if (!(was & half[k]) != !(now & half[k])) return 0;
+		}
+	}
+	return 1;
+} // end same_1bit
+
+
+//	runs in the compressed bytes (a run ends on a nibble without 0x8)
+static long store_runs(void)
+{
+	long runs = 0;
+
+	for (uint8_t b : store)
+	{
+		if (!(b & 0x80)) ++runs;
+		if (!(b & 0x08)) ++runs;
+	}
+	return runs - 1;					// (pad nibble)
+} // end store_runs
+
+
+//******************************************************************************
+//	save, clear, restore: the display comes back pixel for pixel at 1 bit
+//	per pixel; size against 3240 bytes (1 bit per pixel) and the number
+//	of runs (a byte per run)
+//
+static void test_round_trip(const char* name, int strokes, int what)
+{
+	uint16 size;
+	long runs;
+	int same;
+
+	canvas_setup();
+	if (what == 1)						// splash screen
+	{
+		lcd_wordImage(etch_a_sketch_image, (160 - 111) / 2, 45, 1);
+		lcd_wordImage(byu1_image, (160 - 60) / 2, 78, 1);
+		lcd_wordImage(etch_a_sketch1_image, (160 - 141) / 2, 12, 1);
+	}
+	else if (what == 2)					// 12 lines of text
+	{
+		for (int i = 0; i < 12; ++i)
+		{
+			lcd_cursor(0, 150 - i * 12);
+			lcd_printf("%2d The quick brown fox", i);
+		}
+	}
+	else sketch(strokes);
+	memcpy(drawn, lcd_model.ram, sizeof(drawn));
+
+	store.clear();
+	size = lcd_canvas_save(store_put);
+	runs = store_runs();
+	lcd_clear();
+	store_at = 0;
+	CHECK(lcd_canvas_restore(store_get) == 0);
+	same = same_1bit();
+	CHECK(same && (size == store.size()));
+	printf("  %-18s %4u bytes (%6.1f:1), %4ld runs, %s\n", name,
+		(unsigned)size, 3240.0 / size, runs, same ? "same" : "DIFFERS");
+} // end test_round_trip
+
+
+//******************************************************************************
+//	FRAM store: a new part is formatted by fram_init, store/clear/load
+//	round trips; without FRAM both fail and the display is kept
+//
+static void test_store(void)
+{
+	uint16 size;
+	uint8 load;
+	int same, kept;
+
+	canvas_setup();
+	CHECK(fram_init() == 0);
+	sketch(60);
+	memcpy(drawn, lcd_model.ram, sizeof(drawn));
+	size = lcd_canvas_store();
+	lcd_clear();
+	load = lcd_canvas_load();
+	same = same_1bit();
+	CHECK(size && !load && same);
+	printf("  FRAM (new part): store %u bytes, load %u, %s\n",
+		(unsigned)size, (unsigned)load, same ? "same" : "DIFFERS");
+
+	canvas_setup();
+	sim_i2c_detach(FRAM_ADDR);
+	CHECK(fram_init() == SYS_ERR_FRAM);
+	sketch(10);
+	memcpy(drawn, lcd_model.ram, sizeof(drawn));
+	size = lcd_canvas_store();
+	load = lcd_canvas_load();
+	kept = lcd_model.same(drawn);
+	CHECK(!size && load && kept);
+	printf("  no FRAM: store %u, load %u, display %s\n", (unsigned)size,
+		(unsigned)load, kept ? "kept" : "CHANGED");
+} // end test_store
+
+
+int main(void)
+{
+	printf("\n");
+	test_round_trip("blank", 0, 0);
+	test_round_trip("10 strokes", 10, 0);
+	test_round_trip("30 strokes", 30, 0);
+	test_round_trip("60 strokes", 60, 0);
+	test_round_trip("120 strokes", 120, 0);
+	test_round_trip("400 strokes", 400, 0);
+	test_round_trip("splash screen", 0, 1);
+	test_round_trip("12 lines of text", 0, 2);
+	test_store();
+	return test_done();
+} // end main
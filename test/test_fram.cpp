@@ -0,0 +1,126 @@
+//	test_fram.cpp - RBX430_fram.c against an FM24CL64B (2 address byte
+//	memory slave) - allocation table, data and bus throughput
+//******************************************************************************
+//******************************************************************************
+//	Throughput is the time fram_read, fram_write and fram_lcd take for
+//	6480 bytes (a 160 x 60 pixel image), MCLK 8MHz.  The model counts bus
+//	time and the polls that read TAR, not the instructions between them.
+//
+#include "sim.h"
+#include "slaves.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+#include "RBX430_uart.h"
+#include "RBX430_lcd.h"
+#include "RBX430_fram.h"
+
+#define IMAGE_WORDS	(54 * 60)			// 160 x 60 pixels
+#define IMAGE_BYTES	(IMAGE_WORDS * 2)
+
+void WriteCmd(uint8 c);
+void lcd_set_window(uint8 col0, uint8 col1, uint8 line0, uint8 line1);
+
+static MemSlave* fram;
+static uint16 image[IMAGE_WORDS];
+
+
+static void fram_setup(uint16 kHz)
+{
+	delete fram;
+	sim_init(8000);
+	fram = new MemSlave(2, FRAM_SIZE);
+	sim_i2c_attach(FRAM_ADDR, fram);
+	uart_init(115200);
+	__enable_interrupt();
+	i2c_init(kHz);
+} // end fram_setup
+
+
+//******************************************************************************
+//	new part is formatted, blobs are allocated first fit, deleted space
+//	is reused, a missing part fails
+//
+static void test_table(void)
+{
+	uint16 a, b, c, size = 0;
+
+	fram_setup(400);
+	memset(fram->mem.data(), 0xff, FRAM_SIZE);
+	CHECK(fram_init() == 0);
+	CHECK((fram->mem[0] == 0xa1) && (fram->mem[1] == 0xf7));
+	CHECK(fram_find("canvas", 0) == 0);
+
+	a = fram_create("canvas", 3666);
+	b = fram_create("image", 2000);
+	CHECK(a && b && (b == a + 3666));
+	CHECK(fram_create("canvas", 10) == 0);	// name used
+	CHECK(fram_create("big", FRAM_SIZE - b - 2000 + 1) == 0);	// no room
+	CHECK((fram_find("image", &size) == b) && (size == 2000));
+
+	CHECK(fram_delete("canvas") == 0);
+	CHECK(fram_find("canvas", 0) == 0);
+	c = fram_create("small", 100);
+	CHECK(c == a);						// first fit - in the freed space
+
+	CHECK(fram_init() == 0);			// table kept
+	CHECK(fram_find("image", 0) == b);
+
+	sim_i2c_detach(FRAM_ADDR);
+	CHECK(fram_init() == SYS_ERR_FRAM);
+	printf("\n  format, create, find, delete, first fit, no part: %s\n",
+		test_failures ? "FAILED" : "ok");
+} // end test_table
+
+
+//******************************************************************************
+//	fram_write, fram_read and fram_lcd of one image at kHz - the data
+//	round trips and lands in the LCD RAM
+//
+static void test_speed(uint16 kHz)
+{
+	static uint16 back[IMAGE_WORDS];
+	uint64_t start;
+	double w_ms, r_ms, l_ms;
+	int i, bad = 0;
+
+	for (i = 0; i < IMAGE_WORDS; ++i) image[i] = i * 0x9e37 + (i >> 3);
+	fram_setup(kHz);
+	lcd_init();
+	lcd_clear();
+
+	start = sim_cycles();
+	CHECK(fram_write(0x100, image, IMAGE_BYTES) == 0);
+	w_ms = sim_ms(sim_cycles() - start);
+	CHECK(!memcmp(fram->mem.data() + 0x100, image, IMAGE_BYTES));
+
+	start = sim_cycles();
+	CHECK(fram_read(0x100, back, IMAGE_BYTES) == 0);
+	r_ms = sim_ms(sim_cycles() - start);
+	CHECK(!memcmp(back, image, IMAGE_BYTES));
+
+	lcd_set_window(0, 53, 40, 99);
+	WriteCmd(0x5c);
+	start = sim_cycles();
+	CHECK(fram_lcd(0x100, IMAGE_WORDS) == 0);
+	l_ms = sim_ms(sim_cycles() - start);
+	for (i = 0; i < IMAGE_WORDS; ++i)
+	{
+		if (lcd_model.word(i % 54, 40 + i / 54) != image[i]) ++bad;
+	}
+	CHECK(bad == 0);
+
+	printf("  %3u kHz: fram_read %.1fK/s, fram_lcd %.1fK/s, fram_write"
+		" %.1fK/s (%u bytes: %.0f, %.0f, %.0f ms)\n", (unsigned)kHz,
+		IMAGE_BYTES / r_ms, IMAGE_BYTES / l_ms, IMAGE_BYTES / w_ms,
+		IMAGE_BYTES, r_ms, l_ms, w_ms);
+} // end test_speed
+
+
+int main(void)
+{
+	test_table();
+	test_speed(100);
+	test_speed(200);
+	test_speed(400);
+	return test_done();
+} // end main
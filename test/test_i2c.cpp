@@ -0,0 +1,166 @@
+//	test_i2c.cpp - RBX430_i2c.c against the USCI_B0 model and memory slaves
+//******************************************************************************
+//******************************************************************************
+//
+#include "sim.h"
+#include "slaves.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+#include "RBX430_uart.h"
+
+#define REG		0x48					// register file slave
+#define MEM		0x50					// 2 address byte memory
+#define NONE	0x22					// nobody there
+
+static MemSlave reg(1, 256);
+static MemSlave mem(2, 8192);
+
+
+static void i2c_setup(uint16 kHz)
+{
+	sim_init(8000);
+	reg = MemSlave(1, 256);
+	mem = MemSlave(2, 8192);
+	sim_i2c_attach(REG, &reg);
+	sim_i2c_attach(MEM, &mem);
+	uart_init(115200);					// (shares the USCIAB0 vectors)
+	__enable_interrupt();
+	i2c_init(kHz);
+} // end i2c_setup
+
+
+//******************************************************************************
+//	writes, write + read with repeated start, single byte read
+//
+static void test_transfers(void)
+{
+	static const uint8 w[] = { 0x10, 0xa1, 0xb2, 0xc3 };
+	static const uint8 a[] = { 0x12, 0x34 };
+	uint8 r[4] = { 0 };
+	uint8 one = 0;
+	int ok;
+
+	i2c_setup(100);
+	CHECK(i2c_write_read(REG, w, 4, 0, 0) == I2C_OK);
+	CHECK((reg.mem[0x10] == 0xa1) && (reg.mem[0x12] == 0xc3));
+	CHECK(i2c_trace == "S 48 W 10 a1 b2 c3 P ");
+
+	i2c_trace.clear();
+	CHECK(i2c_write_read(REG, w, 1, r, 3) == I2C_OK);
+	CHECK((r[0] == 0xa1) && (r[1] == 0xb2) && (r[2] == 0xc3));
+	CHECK(i2c_trace == "S 48 W 10 Sr 48 R a1 b2 c3 P ");
+
+	i2c_trace.clear();					// read only - 1 byte, then stop
+	ok = i2c_write_read(REG, 0, 0, &one, 1);
+	CHECK(ok == I2C_OK);
+	CHECK(one == 0x00);					// (pointer was at 0x13)
+	CHECK(i2c_trace == "S 48 R 00 P ");
+
+	mem.mem[0x1234] = 0x5a;				// 2 address bytes, 1 byte read
+	i2c_trace.clear();
+	CHECK(i2c_write_read(MEM, a, 2, &one, 1) == I2C_OK);
+	CHECK(one == 0x5a);
+	CHECK(i2c_trace == "S 50 W 12 34 Sr 50 R 5a P ");
+	printf("\n  write, write+read, 1 byte reads: %s\n",
+		test_failures ? "FAILED" : "ok");
+} // end test_transfers
+
+
+//******************************************************************************
+//	no acknowledge (address, last data byte), stuck slave, caller's GIE
+//
+static void test_errors(void)
+{
+	static const uint8 w[] = { 0x00, 1, 2, 3 };
+	uint8 r[2];
+	uint64_t start;
+	double ms_data, ms_stop;
+	int st_addr, st_data, st_next, st_stuck, st_stop, st_after, gie;
+
+	i2c_setup(100);
+	st_addr = i2c_write_read(NONE, w, 2, 0, 0);
+	CHECK(st_addr == SYS_ERR_I2C_ACK);
+	CHECK(i2c_trace == "S 22 W NACK P ");
+
+	reg.nack_after = 2;					// NACK the 3rd data byte (last)
+	st_data = i2c_write_read(REG, w, 4, 0, 0);
+	CHECK(st_data == SYS_ERR_I2C_ACK);
+	reg.nack_after = -1;
+	st_next = i2c_write_read(REG, w, 1, r, 2);
+	CHECK(st_next == I2C_OK);
+	CHECK((r[0] == 1) && (r[1] == 2));
+
+	reg.stuck = 1;						// SCL held in a byte
+	start = sim_cycles();
+	st_stuck = i2c_write_read(REG, w, 4, 0, 0);
+	ms_data = sim_ms(sim_cycles() - start);
+	CHECK(st_stuck == SYS_ERR_I2C_TO);
+	CHECK((ms_data > I2C_TIMEOUT_MS - 1) && (ms_data < I2C_TIMEOUT_MS + 1));
+	reg.stuck = 0;
+
+	reg.stuck_at_stop = 1;				// SCL held at the stop
+	start = sim_cycles();
+	st_stop = i2c_write_read(REG, w, 2, 0, 0);
+	ms_stop = sim_ms(sim_cycles() - start);
+	CHECK(st_stop == SYS_ERR_I2C_TO);
+	CHECK(ms_stop < 2.5);
+	reg.stuck_at_stop = 0;
+	st_after = i2c_write_read(REG, w, 1, r, 2);
+	CHECK(st_after == I2C_OK);
+
+	__disable_interrupt();
+	CHECK(i2c_write_read(REG, w, 1, r, 1) == I2C_OK);
+	gie = (SR & GIE) != 0;
+	CHECK(!gie);
+	__enable_interrupt();
+	CHECK(i2c_write_read(REG, w, 1, r, 1) == I2C_OK);
+	CHECK(SR & GIE);
+	printf("  address NACK %d, last byte NACK %d, next %d; held in byte %d"
+		" after %.2f ms, held at stop %d after %.2f ms, then %d;"
+		" GIE off kept %d\n", st_addr, st_data, st_next, st_stuck, ms_data,
+		st_stop, ms_stop, st_after, !gie);
+} // end test_errors
+
+
+//******************************************************************************
+//	UART bytes keep arriving at 115200 during back to back transactions
+//	(the ISRs share a vector pair) - no ISR may hold up the receiver
+//
+static void test_uart_share(uint16 kHz)
+{
+	static const uint8 w[] = { 0x20, 9, 8, 7, 6 };
+	uint8 line[200], r[6];
+	std::string got;
+	int16 c;
+	int i, n = 0, bad = 0;
+
+	i2c_setup(kHz);
+	for (i = 0; i < (int)sizeof(line); ++i) line[i] = i ^ 0x5a;
+	sim_uart_rx(line, sizeof(line));
+	while (got.size() < sizeof(line))
+	{
+		if (i2c_write_read(REG, w, 5, 0, 0) != I2C_OK) ++bad;
+		if (i2c_write_read(REG, w, 1, r, 4) != I2C_OK) ++bad;
+		if (i2c_write_read(REG, 0, 0, r, 1) != I2C_OK) ++bad;
+		n += 3;
+		while ((c = uart_getc()) >= 0) got += (char)c;
+		if (n > 3000) break;
+	}
+	CHECK(bad == 0);
+	CHECK(uart_overruns == 0);
+	CHECK(uart_rx_lost == 0);
+	CHECK(got == std::string((char*)line, sizeof(line)));
+	printf("  %u kHz: %d transactions (%d failed) with 200 UART bytes in:"
+		" %ld overruns, longest ISR %.1f us\n", kHz, n, bad, uart_overruns,
+		sim_ms(isr_longest) * 1000);
+} // end test_uart_share
+
+
+int main(void)
+{
+	test_transfers();
+	test_errors();
+	test_uart_share(100);
+	test_uart_share(400);
+	return test_done();
+} // end main
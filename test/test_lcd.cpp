@@ -0,0 +1,172 @@
+//	test_lcd.cpp - RBX430_lcd.c screen set and lcd_wordImage through the
+//	burst writers (lcd_bus.c stands in for RBX430_lcd_bus.asm)
+//******************************************************************************
+//******************************************************************************
+//	lcd_wordImage is checked against a decoder of the table format as
+//	tools/lcd_image.py documents it, not against the driver's own code.
+//
+#include "sim.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+#define BYU3_LOGO	1
+#define BYU4_LOGO	1
+#include "lcd_byu_images.c"
+#include "lcd_etch-a-sketch_images.c"
+
+static uint16_t want[160][54];			// expected RAM words
+static long loads;						// bytes put on P2 (P2OUT writes)
+
+
+static void p2out_wr(uint8_t was, uint8_t now)
+{
+	++loads;
+} // end p2out_wr
+
+
+static void lcd_setup(void)
+{
+	sim_init(8000);
+	P2OUT.wr = p2out_wr;
+	lcd_init();
+} // end lcd_setup
+
+
+//******************************************************************************
+//	lcd_clear: one pass over the 54 x 160 word window, every pixel off;
+//	a solid word goes on P2 once, then only E is strobed (the low byte
+//	reads back 0xff, bit 5 included)
+//
+static void test_clear(void)
+{
+	long words;
+	int line, b, on = 0, low = 0;
+
+	lcd_setup();
+	memset(lcd_model.ram, 0, sizeof(lcd_model.ram));	// all on
+	lcd_model.reset_counts();
+	loads = 0;
+	lcd_clear();
+	words = (lcd_model.writes - 4) / 2;	// (4 window params)
+	for (line = 0; line < 160; ++line)
+	{
+		for (b = 0; b < 108; ++b)
+		{
+			if (~lcd_model.ram[line][b] & ((b & 1) ? 0xdf : 0xff)) ++on;
+			if ((b & 1) && (lcd_model.ram[line][b] == 0xff)) ++low;
+		}
+	}
+	CHECK(on == 0);
+	CHECK(words == 54 * 160);
+	CHECK(loads == lcd_model.cmds + 4 + 1);	// commands, params, 1 data
+	CHECK(low == 54 * 160);
+	printf("\n  lcd_clear: %ld words (54 x 160), %ld strobes, %ld P2 loads,"
+		" %d bytes not off\n", words, lcd_model.strobes, loads, on);
+} // end test_clear
+
+
+//******************************************************************************
+//	lcd_write_repeat of a solid word (both bytes equal ignoring bit 5)
+//	loads P2 once; other words load it twice per word
+//
+static void test_repeat(void)
+{
+	static const uint16 word[] = { 0xffdf, 0x0000, 0xffff, 0x07c0, 0x1234 };
+	long solid[5];
+	int i;
+
+	lcd_setup();
+	for (i = 0; i < 5; ++i)
+	{
+		lcd_set_lines(0, 0, 1);			// (window, RAMWR)
+		loads = 0;
+		lcd_write_repeat(word[i], 100);
+		solid[i] = loads;
+	}
+	CHECK((solid[0] == 1) && (solid[1] == 1) && (solid[2] == 1));
+	CHECK((solid[3] == 200) && (solid[4] == 200));
+	printf("  lcd_write_repeat x 100: P2 loads %ld (ffdf), %ld (0000), %ld"
+		" (ffff), %ld (07c0), %ld (1234)\n", solid[0], solid[1], solid[2],
+		solid[3], solid[4]);
+} // end test_repeat
+
+
+//******************************************************************************
+//	table decoder: rows top down from line y + height, each row's words
+//	right to left from word column divu3(159 - right pixel) - runs carry
+//	into the next row
+//
+static void image_decode(const uint16* image, int16 x, int16 y)
+{
+	uint16 width = *image++;
+	uint16 height = *image++;
+	int col = (159 - (x + width - 1)) / 3;
+	int words = (width + 2) / 3;
+	int run = 0, r, i;
+	uint16 pixels = 0;
+
+	for (r = 0; r < height; ++r)
+	{
+		for (i = 0; i < words; ++i)
+		{
+			while (!run && (*image & 0x0020))	// ccff, ccfe, ccf0 pppp
+			{
+				run = *image >> 8;
+				switch (*image++ & 0xff)
+				{
+					case 0xff: pixels = 0xffdf; break;
+					case 0xfe: pixels = 0x0000; break;
+					default: pixels = ~*image++; break;
+				}
+			}
+			if (run)
+			{
+				want[y + height - r][col + i] = pixels;
+				--run;
+			}
+			else want[y + height - r][col + i] = ~*image++;
+		}
+	}
+	return;
+} // end image_decode
+
+
+//******************************************************************************
+//	lcd_wordImage draws every image table word where the format puts it
+//	(and nothing else)
+//
+static void test_image(const char* name, const uint16* image, int16 x,
+	int16 y)
+{
+	int line, c, bad = 0;
+
+	lcd_setup();
+	lcd_clear();
+	for (line = 0; line < 160; ++line)
+		for (c = 0; c < 54; ++c) want[line][c] = lcd_model.word(c, line);
+	image_decode(image, x, y);
+
+	lcd_model.reset_counts();
+	loads = 0;
+	lcd_wordImage(image, x, y, 1);
+	for (line = 0; line < 160; ++line)
+		for (c = 0; c < 54; ++c)
+			if ((lcd_model.word(c, line) ^ want[line][c]) & 0xffdf) ++bad;
+	CHECK(bad == 0);
+	printf("  %-20s %3d x %2d at %3d,%3d: %d words differ, %ld strobes,"
+		" %ld P2 loads\n", name, image[0], image[1], x, y, bad,
+		lcd_model.strobes, loads);
+} // end test_image
+
+
+int main(void)
+{
+	test_clear();
+	test_repeat();
+	test_image("byu1_image", byu1_image, 50, 78);
+	test_image("byu3_image", byu3_image, 1, 10);
+	test_image("byu4_image", byu4_image, 85, 100);
+	test_image("etch_a_sketch_image", etch_a_sketch_image, 24, 45);
+	test_image("etch_a_sketch1_image", etch_a_sketch1_image, 9, 12);
+	return test_done();
+} // end main
@@ -0,0 +1,176 @@
+//	test_motion.cpp - shake detection through the ADXL345 driver, with
+//	main loop stalls; the stalls the program makes
+//******************************************************************************
+//******************************************************************************
+//	The model plays 1g at rest with bursts of 3g on x: 4 samples up,
+//	4 down - one SHAKE_G crossing per 8 samples (100Hz).  The main loop
+//	takes samples every 5ms except while stalled.
+//
+#include "sim.h"
+#include "slaves.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+#include "RBX430_uart.h"
+#include "RBX430_lcd.h"
+#include "RBX430_fram.h"
+#include "RBX430_adxl345.h"
+#include "etch-a-sketch.h"
+
+#define MS		8000					// cycles per ms (8MHz)
+
+static Adxl345* xl;
+static MemSlave* fram;
+static int burst_at[2], burst_n[2];		// bursts (first sample, crossings)
+static long shakes;
+static double shake_ms;					// when last detected
+
+
+void PORT1_ISR(void)
+{
+	if (P1IFG & ADXL345_INT) xl_port1_isr();
+} // end PORT1_ISR
+
+
+static int16_t shake_wave(uint16_t n, int axis)
+{
+	for (int b = 0; b < 2; ++b)
+	{
+		if ((n >= burst_at[b]) && (n < burst_at[b] + burst_n[b] * 8))
+		{
+			if (axis == 0) return ((n - burst_at[b]) & 4) ? 0 : 3 * XL_1G;
+			return 0;
+		}
+	}
+	return (axis == 2) ? XL_1G : 0;		// at rest
+} // end shake_wave
+
+
+static void motion_setup(int at0, int n0, int at1, int n1)
+{
+	static Adxl345* model;
+
+	delete model;
+	delete fram;
+	sim_init(8000);
+	model = xl = new Adxl345(8000);
+	xl->wave = shake_wave;
+	burst_at[0] = at0;
+	burst_n[0] = n0;
+	burst_at[1] = at1;
+	burst_n[1] = n1;
+	fram = new MemSlave(2, FRAM_SIZE);
+	sim_i2c_attach(XL_ADDR, xl);
+	sim_i2c_attach(FRAM_ADDR, fram);
+	uart_init(115200);
+	__enable_interrupt();
+	i2c_init(100);
+	CHECK(xl_init(XL_RATE_100HZ) == 0);
+	shakes = 0;
+	shake_ms = 0;
+} // end motion_setup
+
+
+//	main loop for ms, not taking samples from stall_at for stall ms
+static void motion_loop(int ms, int stall_at, int stall)
+{
+	XL_SAMPLE s;
+	int t;
+
+	for (t = 0; t < ms; t += 5)
+	{
+		sim_run(5 * MS);
+		if ((t >= stall_at) && (t < stall_at + stall)) continue;
+		while (xl_read(&s))
+		{
+			if (motion_shake(&s))
+			{
+				++shakes;
+				shake_ms = sim_ms(sim_cycles());
+			}
+		}
+	}
+} // end motion_loop
+
+
+//******************************************************************************
+//	one shake (4 crossings, samples 100-131 = 1.00-1.32s)
+//
+static void test_shake(int stall_at, int stall, int want)
+{
+	motion_setup(100, 4, 0, 0);
+	motion_loop(4000, stall_at, stall);
+	CHECK(shakes == want);
+	printf("  shake at 1.0-1.3s, stall %4d ms from %4d ms: %ld detected",
+		stall, stall_at, shakes);
+	if (shakes) printf(" at %.0f ms", shake_ms);
+	printf(", xl_lost %u\n", (unsigned)xl_lost);
+} // end test_shake
+
+
+//******************************************************************************
+//	two half shakes (2 crossings each, 0.85s apart) around a stall that
+//	loses the samples between them - must not add up to a shake
+//
+static void test_halves(void)
+{
+	motion_setup(100, 2, 185, 2);
+	motion_loop(3000, 1200, 850);
+	CHECK(shakes == 0);
+	CHECK(xl_lost > 0);
+	printf("  half shakes at 1.00s and 1.85s, stall 850 ms from 1200 ms:"
+		" %ld detected, xl_lost %u\n", shakes, (unsigned)xl_lost);
+} // end test_halves
+
+
+//******************************************************************************
+//	stalls this program makes that can be timed here (bus bound)
+//
+static void test_stalls(void)
+{
+	uint64_t start;
+	double store_ms, load_ms;
+	uint16 size;
+	int passes, i;
+
+	motion_setup(0, 0, 0, 0);
+	P1IE &= ~ADXL345_INT;				// (just the display and FRAM)
+	lcd_init();
+	lcd_clear();
+	CHECK(fram_init() == 0);
+
+	for (i = 0; i < 12; ++i)			// a busy drawing
+	{
+		lcd_circle(80, 80, 6 + i * 6, 1);
+		lcd_square(80, 80, 3 + i * 6, 1);
+	}
+	lcd_cursor(4, 150);
+	lcd_printf("Etch-a-Sketch 430");
+
+	start = sim_cycles();
+	size = lcd_canvas_store();
+	store_ms = sim_ms(sim_cycles() - start);
+	CHECK(size != 0);
+	lcd_clear();
+	start = sim_cycles();
+	CHECK(lcd_canvas_load() == 0);
+	load_ms = sim_ms(sim_cycles() - start);
+
+	lcd_queue_clear();
+	for (passes = 0; lcd_queue_run(LCD_QUEUE_BUDGET); ++passes);
+	printf("  canvas store %u bytes: %.0f ms, load %.0f ms (I2C time);"
+		" queued clear: %d passes of %u us\n", size, store_ms, load_ms,
+		passes + 1, LCD_QUEUE_BUDGET);
+} // end test_stalls
+
+
+int main(void)
+{
+	printf("\n");
+	test_shake(0, 0, 1);
+	test_shake(900, 300, 1);			// shake waits in the FIFO
+	test_shake(1000, 340, 1);
+	test_shake(900, 2300, 0);			// screenshot - shake lost
+	test_halves();
+	test_stalls();
+	return test_done();
+} // end main
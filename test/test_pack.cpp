@@ -0,0 +1,75 @@
+//	test_pack.cpp - lcd_pack.c packed images against lcd_wordImage
+//******************************************************************************
+//******************************************************************************
+//	The Makefile packs the BYU and Etch-a-Sketch tables with
+//	tools/lcd_image.py --pack (lcd_pack_images.c, packed_<name>).
+//
+#include "sim.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+#define BYU3_LOGO	1
+#define BYU4_LOGO	1
+#include "lcd_byu_images.c"
+#include "lcd_etch-a-sketch_images.c"
+#include "lcd_pack_images.c"
+
+static uint8_t drawn[160][108];			// lcd_wordImage result
+static long loads;						// bytes put on P2 (P2OUT writes)
+
+
+static void p2out_wr(uint8_t was, uint8_t now)
+{
+	++loads;
+} // end p2out_wr
+
+
+//******************************************************************************
+//	lcd_packImage draws what lcd_wordImage draws (bit 5 aside) from a
+//	smaller table
+//
+static void test_pack(const char* name, const uint16* image, uint16 bytes,
+	const uint8* packed, uint16 pack_bytes, uint16 want, int16 x, int16 y)
+{
+	long word_strobes, word_loads;
+	int same;
+
+	sim_init(8000);
+	P2OUT.wr = p2out_wr;
+	lcd_init();
+	lcd_clear();
+	lcd_model.reset_counts();
+	loads = 0;
+	lcd_wordImage(image, x, y, 1);
+	word_strobes = lcd_model.strobes;
+	word_loads = loads;
+	memcpy(drawn, lcd_model.ram, sizeof(drawn));
+
+	lcd_clear();
+	lcd_model.reset_counts();
+	loads = 0;
+	CHECK(lcd_packImage(packed, x, y) == 0);
+	same = lcd_model.same(drawn);
+	CHECK(same);
+	CHECK(pack_bytes == want);
+	printf("  %-20s %4u -> %4u bytes (%2.0f%% smaller), %s; strobes %ld"
+		" (wordImage %ld), P2 loads %ld (%ld)\n", name, (unsigned)bytes,
+		(unsigned)pack_bytes, 100.0 - 100.0 * pack_bytes / bytes,
+		same ? "same" : "DIFFERS", lcd_model.strobes, word_strobes, loads,
+		word_loads);
+} // end test_pack
+
+
+#define PACK(name, want, x, y)	test_pack(#name, name, sizeof(name), \
+		packed_##name, sizeof(packed_##name), want, x, y)
+
+int main(void)
+{
+	printf("\n");
+	PACK(byu1_image, 678, 50, 78);
+	PACK(byu3_image, 1694, 1, 10);
+	PACK(byu4_image, 784, 85, 100);
+	PACK(etch_a_sketch_image, 1847, 24, 45);
+	PACK(etch_a_sketch1_image, 1064, 9, 12);
+	return test_done();
+} // end main
@@ -0,0 +1,248 @@
+//	test_remote.cpp - frames from tools/lcd_remote.py into lcd_remote_task
+//******************************************************************************
+//******************************************************************************
+//	lcd_remote.py writes its frames to a file when the port is not a
+//	device.  The frames arrive through the USCI_A0 model at 115200 baud
+//	(8 MHz), one at a time as the tool sends them (next frame after the
+//	reply), and the display is checked in the ST7529 model.
+//
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+#include "RBX430_uart.h"
+#include "RBX430_telemetry.h"
+
+uint8 lcd_remote_task(void);
+
+#define PGM_W		61					// test image
+#define PGM_H		45
+#define PGM_LEFT	30
+#define PGM_TOP		120
+
+static const uint8 cursor[] = { 5, 5, 0x20, 0x20, 0xd8, 0x20, 0x20 };
+static uint8 before[160][108];
+
+
+//******************************************************************************
+//	run lcd_remote.py (port = file), return the frames it wrote
+//
+static std::vector<std::string> tool_frames(const char* args)
+{
+	std::vector<std::string> frames;
+	std::string cmd = std::string("python3 ../tools/lcd_remote.py "
+		"build/remote.bin ") + args;
+	std::string all, f;
+	FILE* fp;
+	int c;
+
+	if (system(cmd.c_str()) != 0) sim_fail(cmd.c_str());
+	if (!(fp = fopen("build/remote.bin", "rb"))) sim_fail("build/remote.bin");
+	while ((c = fgetc(fp)) != EOF) all += (char)c;
+	fclose(fp);
+	for (size_t i = 0; i < all.size(); ++i)	// 0x00 .. 0x00
+	{
+		f += all[i];
+		if (!all[i] && (f.size() > 1))
+		{
+			frames.push_back(f);
+			f.clear();
+		}
+	}
+	return frames;
+} // end tool_frames
+
+
+//******************************************************************************
+//	the reply frame sent since the last call (-1 if none or bad)
+//
+static int reply_status(void)
+{
+	std::vector<uint8_t> raw, msg;
+	size_t i, n;
+
+	while (uart_tx_busy()) sim_run(sim_uart_byte());
+	for (i = 0; i < uart_out.size(); ++i)
+	{
+		if (uart_out[i]) raw.push_back(uart_out[i]);
+	}
+	uart_out.clear();
+	for (i = 0; i < raw.size(); i += n)	// COBS decode
+	{
+		n = raw[i];
+		msg.insert(msg.end(), raw.begin() + i + 1, raw.begin() + i + n);
+		if ((n < 0xff) && (i + n < raw.size())) msg.push_back(0);
+	}
+	if ((msg.size() != 4) || (tm_crc16(msg.data(), 2) != (msg[2] | (msg[3] << 8))))
+	{
+		return -1;
+	}
+	return msg[0];
+} // end reply_status
+
+
+//******************************************************************************
+//	send one frame the way the main loop meets it, return the reply status
+//
+static int send_frame(const std::string& f, uint64_t* took)
+{
+	uint64_t start = sim_cycles();
+
+	sim_uart_rx((const uint8_t*)f.data(), f.size());
+	while (!uart_rx_count()) sim_run(8);
+	if (uart_rx_count()) lcd_sprite_hide(0);	// (etch-a-sketch.c main loop)
+	while (!lcd_remote_task()) sim_run(8);
+	if (took) *took = sim_cycles() - start;
+	return reply_status();
+} // end send_frame
+
+
+static void remote_init(void)
+{
+	sim_init(8000);
+	uart_init(115200);
+	tm_init();
+	__enable_interrupt();
+	lcd_init();
+	lcd_clear();
+	lcd_sprite_init(0, cursor, SPRITE_XOR);
+} // end remote_init
+
+
+//******************************************************************************
+//	image: every pixel lands in the right RAM line and field at the
+//	PGM gray (0-31), at about the baud rate
+//
+static void test_image(void)
+{
+	FILE* fp;
+	std::vector<std::string> frames;
+	uint64_t took, total = 0;
+	long bytes = 0;
+	int x, y, gray, bad = 0, status = 0;
+
+	if (!(fp = fopen("build/remote.pgm", "wb"))) sim_fail("build/remote.pgm");
+	fprintf(fp, "P5\n%d %d\n255\n", PGM_W, PGM_H);
+	for (y = 0; y < PGM_H; ++y)
+		for (x = 0; x < PGM_W; ++x) fputc((x * 4 + y * 3) & 0xff, fp);
+	fclose(fp);
+
+	remote_init();
+	frames = tool_frames("image build/remote.pgm --left 30 --top 120");
+	for (auto& f : frames)
+	{
+		if ((status = send_frame(f, &took)) != 0x80) break;
+		total += took;
+		bytes += f.size();
+	}
+	CHECK(status == 0x80);
+
+	for (y = 0; y < PGM_H; ++y)
+	{
+		for (x = 0; x < PGM_W; ++x)
+		{
+			int p = 159 - (PGM_LEFT + x);
+			int line = PGM_TOP - y;
+			uint16_t w = lcd_model.word(p / 3, line);
+			static const int shift[3] = { 0, 6, 11 };
+
+			gray = (((x * 4 + y * 3) & 0xff) * 31 + 127) / 255;
+			if (((w >> shift[p % 3]) & 0x1f) != gray) ++bad;
+		}
+	}
+	CHECK(bad == 0);
+	printf("\n  image %dx%d: %u frames, %ld bytes, %d pixels wrong,"
+		" %.1f ms (%.2f byte times/byte)\n", PGM_W, PGM_H,
+		(unsigned)frames.size(), bytes, bad, sim_ms(total),
+		(double)total / sim_uart_byte() / bytes);
+} // end test_image
+
+
+//******************************************************************************
+//	fill, text and clear match the same calls made directly.  The cursor
+//	sprite sits on the fill: unless it is hidden before the frame (as
+//	the main loop does), hiding it later puts back the words it saved
+//	and punches a hole in the fill.
+//
+static void test_commands(void)
+{
+	uint8 after[160][108];
+	int ok_fill, ok_text, ok_clear;
+
+	remote_init();
+	lcd_sprite_move(0, 48, 18);			// cursor inside the fill
+	lcd_sprite_update(100);
+	CHECK(send_frame(tool_frames("fill 40 10 30 20")[0], 0) == 0x80);
+	lcd_sprite_move(0, 100, 100);		// pen moves on
+	lcd_sprite_update(100);
+	lcd_sprite_hide(0);
+	memcpy(after, lcd_model.ram, sizeof(after));
+	lcd_clear();
+	lcd_fill(40, 10, 30, 20, 2);
+	ok_fill = lcd_model.same(after);
+
+	memcpy(before, lcd_model.ram, sizeof(before));
+	CHECK(send_frame(tool_frames("text 3 140 \"Hello, 430\"")[0], 0) == 0x80);
+	memcpy(after, lcd_model.ram, sizeof(after));
+	memcpy(lcd_model.ram, before, sizeof(before));
+	lcd_cursor(3, 140);
+	lcd_printf("%s", "Hello, 430");
+	ok_text = lcd_model.same(after);
+
+	CHECK(send_frame(tool_frames("clear")[0], 0) == 0x80);
+	memcpy(after, lcd_model.ram, sizeof(after));
+	lcd_clear();
+	ok_clear = lcd_model.same(after);
+
+	CHECK(ok_fill);
+	CHECK(ok_text);
+	CHECK(ok_clear);
+	printf("  fill (under the cursor)/text/clear same as direct calls:"
+		" %d/%d/%d\n", ok_fill, ok_text, ok_clear);
+} // end test_commands
+
+
+//******************************************************************************
+//	a bad CRC is refused and changes nothing; a frame cut short ends
+//	with RD_ERR_LOST after RD_TIMEOUT_MS of Timer A time
+//
+static void test_errors(void)
+{
+	std::string f;
+	uint64_t start;
+	double ms;
+	int crc, lost;
+
+	remote_init();
+	f = tool_frames("fill 0 0 20 20")[0];
+	f[f.size() - 3] ^= 0x01;			// CRC byte
+	memcpy(before, lcd_model.ram, sizeof(before));
+	crc = send_frame(f, 0);
+	CHECK(crc == 0x81);
+	CHECK(lcd_model.same(before));
+
+	f = tool_frames("fill 0 0 20 20")[0];
+	f.resize(4);						// delimiter, code, cmd, seq
+	sim_uart_rx((const uint8_t*)f.data(), f.size());
+	sim_run(sim_uart_byte() * 5);
+	start = sim_cycles();
+	while (!lcd_remote_task()) sim_run(8);
+	ms = sim_ms(sim_cycles() - start);
+	lost = reply_status();
+	CHECK(lost == 0x83);
+	CHECK((ms >= 249) && (ms < 252));
+	printf("  bad CRC: reply %02x, display unchanged %d;"
+		" cut frame: reply %02x after %.1f ms\n", crc,
+		lcd_model.same(before), lost, ms);
+} // end test_errors
+
+
+int main(void)
+{
+	test_image();
+	test_commands();
+	test_errors();
+	return test_done();
+} // end main
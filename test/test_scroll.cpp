@@ -0,0 +1,122 @@
+//	test_scroll.cpp - hardware scroll and the LCD_SCROLL_TEXT console
+//******************************************************************************
+//******************************************************************************
+//	The ST7529 model shows RAM line (y + scroll * 4) % 160 at display row
+//	y, as the controller does after Scroll Start Set (0xab).
+//
+#include "sim.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+static uint8_t shown[160][160];			// display (x, y) after scrolling
+
+
+static void scroll_setup(uint16 mode)
+{
+	sim_init(8000);
+	lcd_init();
+	lcd_clear();
+	lcd_mode(mode);
+} // end scroll_setup
+
+
+static void shown_save(void)
+{
+	for (int y = 0; y < 160; ++y)
+		for (int x = 0; x < 160; ++x) shown[x][y] = lcd_model.shown(x, y);
+} // end shown_save
+
+
+static long shown_diff(void)
+{
+	long bad = 0;
+
+	for (int y = 0; y < 160; ++y)
+		for (int x = 0; x < 160; ++x)
+			if (shown[x][y] != lcd_model.shown(x, y)) ++bad;
+	return bad;
+} // end shown_diff
+
+
+//******************************************************************************
+//	print count lines through the console - the screen shows the last
+//	ones on whole text rows, newest above the blank bottom row; a new
+//	line on the bottom is one scroll command and one text line of blank
+//	words
+//
+static void test_console(uint16 mode, int count)
+{
+	int rows = HD_Y_MAX / ((mode & LCD_2X_FONT) ? CHAR_SIZE * 2 : CHAR_SIZE);
+	long writes, cmds, bad;
+	int i;
+
+	scroll_setup(0);					// reference - last lines placed
+	lcd_mode(mode & LCD_2X_FONT);
+	for (i = 1; i < rows; ++i)
+	{
+		lcd_cursor(0, i * HD_Y_MAX / rows);
+		lcd_printf("line %02d", count - i);
+	}
+	shown_save();
+
+	scroll_setup(mode);
+	for (i = 0; i < count - 1; ++i) lcd_printf("line %02d\n", i);
+	lcd_printf("line %02d", i);
+	lcd_model.reset_counts();
+	lcd_printf("\n");
+	writes = lcd_model.writes;
+	cmds = lcd_model.cmds;
+	bad = shown_diff();
+	CHECK(bad == 0);
+	CHECK(lcd_model.scroll != 0);
+	CHECK(writes == 54 * 2 * HD_Y_MAX / rows + 4 + 1);
+	printf("  %d lines, %s font: %ld pixels differ, scroll block %d;"
+		" last new line %ld words, %ld commands\n", count,
+		(mode & LCD_2X_FONT) ? "2x" : "1x", bad, lcd_model.scroll,
+		(writes - 5) / 2, cmds);
+} // end test_console
+
+
+//******************************************************************************
+//	lcd_scroll up and down by 4-40 lines: contents move, the lines that
+//	come into view are blank
+//
+static void test_scroll(void)
+{
+	static const int16 lines[] = { 4, 12, 40, -8, -40, 156 };
+	static uint8_t was[160][160];
+	long bad = 0;
+	int i, x, y, at;
+
+	scroll_setup(0);
+	for (y = 0; y < 20; ++y)			// a line of text per row
+	{
+		lcd_cursor(0, y * CHAR_SIZE);
+		lcd_printf("%02d abcdefghijklmnopq", y);
+	}
+	shown_save();
+	for (i = 0; i < (int)(sizeof(lines) / sizeof(lines[0])); ++i)
+	{
+		lcd_scroll(lines[i]);
+		memcpy(was, shown, sizeof(was));
+		for (y = 0; y < 160; ++y)		// moved, or blank if it came in
+		{
+			at = y - lines[i];
+			for (x = 0; x < 160; ++x)
+				shown[x][y] = ((at >= 0) && (at < 160)) ? was[x][at] : 0;
+		}
+		bad += shown_diff();
+	}
+	CHECK(bad == 0);
+	printf("  lcd_scroll 4, 12, 40, -8, -40, 156: %ld pixels differ\n", bad);
+} // end test_scroll
+
+
+int main(void)
+{
+	printf("\n");
+	test_console(LCD_SCROLL_TEXT, 25);
+	test_console(LCD_SCROLL_TEXT | LCD_2X_FONT, 25);
+	test_scroll();
+	return test_done();
+} // end main
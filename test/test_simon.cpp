@@ -0,0 +1,150 @@
+//	test_simon.cpp - Simon's scoreboard tile layer (Simon/lcd_tile.c on
+//	the Simon driver) against the same text drawn with lcd_printf
+//******************************************************************************
+//******************************************************************************
+//	simon.c does not build on the host (Timer B, WDT; C++ reserves its
+//	variable "new"), so the Makefile stages its scoreboard section alone
+//	(simon_score.c, from "// Scoreboard" to the end) and this file
+//	supplies the globals it uses.
+//
+#include <string.h>
+
+#include "sim.h"
+#include "RBX430-1.h"
+#include "RBX430_lcd.h"
+
+#define SIMON_TILE_CHARS " -0123456789CDEHILNORSU" // (as simon.c)
+#define SCORE_COLS 9
+#define SCORE_ROWS 4
+#define SCORE_COL 9						// layer at tile column 9, row 8
+#define SCORE_ROW 8
+
+extern const uint16 simon_tiles[];
+uint8 score_map[SCORE_COLS * SCORE_ROWS];
+int hi_score = 0;
+int lo_score = -1;
+
+void score_init(void);
+void score_show(int round, int score);
+void score_game_over(int score);
+
+#include "simon_score.c"
+
+static uint8_t blank[160][108];		// cleared LCD RAM
+static long strobes[6];					// per step
+
+
+//	each layer row's text (row 3 first) printed with lcd_printf, the
+//	cursor on the first glyph column
+static void score_print(void)
+{
+	char text[SCORE_COLS + 1];
+	int row, col;
+
+	for (row = SCORE_ROWS - 1; row >= 0; --row)
+	{
+		for (col = 0; col < SCORE_COLS; ++col)
+			text[col] = SIMON_TILE_CHARS[score_map[row * SCORE_COLS + col]];
+		text[col] = 0;
+		lcd_cursor(SCORE_COL * 6 - 1, (SCORE_ROW + row) * 8);
+		lcd_printf("%s", text);
+	}
+	return;
+} // end score_print
+
+
+//	scoreboard on the LCD == score_print on a clear screen (drawn on a
+//	copy of the LCD RAM, the tile state is not touched)
+static int score_same(void)
+{
+	static uint8_t shown[160][108];
+	int same;
+
+	memcpy(shown, lcd_model.ram, sizeof(shown));
+	memcpy(lcd_model.ram, blank, sizeof(blank));
+	score_print();
+	same = lcd_model.same(shown);
+	memcpy(lcd_model.ram, shown, sizeof(shown));
+	return same;
+} // end score_same
+
+
+//	full draw, a round won, nothing changed, game over, redraw after a
+//	clear - strobes per step (then the board with lcd_printf), or check
+//	each step's pixels
+static int score_steps(int check)
+{
+	int same = 1, step = 0;
+
+	sim_init(8000);
+	lcd_init();
+	lcd_clear();
+	memcpy(blank, lcd_model.ram, sizeof(blank));
+	hi_score = 0;
+	lo_score = -1;
+
+#define STEP(call)	lcd_model.reset_counts(); call; \
+					strobes[step++] = lcd_model.strobes; \
+					if (check && !score_same()) same = 0
+	STEP(score_init());
+	STEP(score_show(2, 1));				// 2 digits change
+	STEP(score_show(2, 1));
+	STEP(score_game_over(7));			// hi, lo, round and score
+	STEP((lcd_clear(), lcd_model.reset_counts(), lcd_tile_flush()));
+#undef STEP
+	lcd_model.reset_counts();			// same board with lcd_printf
+	score_print();
+	strobes[step] = lcd_model.strobes;
+	return same;
+} // end score_steps
+
+
+//******************************************************************************
+//	scoreboard is pixel for pixel what lcd_printf draws; only changed
+//	tiles are written
+//
+static void test_scoreboard(void)
+{
+	int same = score_steps(1);
+
+	CHECK(same);
+	CHECK((score_map[SCORE_COLS + 7] == 2) && (score_map[SCORE_COLS + 8] == 9));
+	score_steps(0);
+	CHECK(strobes[2] == 0);
+	CHECK(strobes[1] < strobes[0] / 4);
+	CHECK((strobes[4] > 0) && (strobes[4] < strobes[5] / 8));
+	printf("\n  scoreboard %s lcd_printf; strobes: score_init %ld, round"
+		" won %ld, unchanged %ld, game over %ld, whole layer %ld (lcd_printf"
+		" %ld)\n", same ? "same as" : "DIFFERS from", strobes[0],
+		strobes[1], strobes[2], strobes[3], strobes[4], strobes[5]);
+} // end test_scoreboard
+
+
+//******************************************************************************
+//	Simon's lcd_clear: one pass over the 54 x 160 word window (lcd_set),
+//	every pixel off
+//
+static void test_clear(void)
+{
+	long strobes;
+
+	sim_init(8000);
+	lcd_init();
+	memset(lcd_model.ram, 0, sizeof(lcd_model.ram));	// all on
+	lcd_model.reset_counts();
+	lcd_clear();
+	strobes = lcd_model.strobes;
+	memset(blank, 0xff, sizeof(blank));
+	CHECK(lcd_model.same(blank));
+	CHECK(strobes == 54 * 160 * 2 + 7);	// (window, RAMWR)
+	printf("  Simon lcd_clear: %ld strobes, %s\n", strobes,
+		lcd_model.same(blank) ? "all off" : "NOT all off");
+} // end test_clear
+
+
+int main(void)
+{
+	test_scoreboard();
+	test_clear();
+	return test_done();
+} // end main
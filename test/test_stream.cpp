@@ -0,0 +1,140 @@
+//	test_stream.cpp - lcd_stream.c: lcd_wordImage data from flash, FRAM
+//	and the UART draws what lcd_wordImage draws; a cut UART stream times
+//	out on Timer A
+//******************************************************************************
+//******************************************************************************
+//
+#include "sim.h"
+#include "slaves.h"
+#include "RBX430-1.h"
+#include "RBX430_i2c.h"
+#include "RBX430_uart.h"
+#include "RBX430_lcd.h"
+#include "RBX430_fram.h"
+#include "RBX430_telemetry.h"
+
+#define BYU3_LOGO	1
+#include "lcd_byu_images.c"				// (sizeof the tables)
+
+#define IMAGE_AT	0x200				// FRAM address
+
+static MemSlave* fram;
+static uint8_t drawn[160][108];			// lcd_wordImage result
+
+
+static void stream_setup(void)
+{
+	delete fram;
+	sim_init(8000);
+	fram = new MemSlave(2, FRAM_SIZE);
+	sim_i2c_attach(FRAM_ADDR, fram);
+	uart_init(115200);
+	tm_init();
+	__enable_interrupt();
+	i2c_init(400);
+	lcd_init();
+	lcd_clear();
+} // end stream_setup
+
+
+//******************************************************************************
+//	each source draws image pixel for pixel as lcd_wordImage (at x, y)
+//
+static void test_sources(const char* name, const uint16* image,
+	uint16 bytes, int16 x, int16 y)
+{
+	LCD_STREAM stream;
+	LCD_JOB job;
+	uint64_t start;
+	double ms_fram, ms_uart;
+	long bus, passes = 0;
+	int ok_flash, ok_fram, ok_job, ok_uart;
+
+	stream_setup();
+	lcd_wordImage(image, x, y, 1);
+	memcpy(drawn, lcd_model.ram, sizeof(drawn));
+
+	lcd_clear();
+	lcd_stream_flash(&stream, image);
+	CHECK(lcd_streamImage(&stream, x, y, 1) == 0);
+	ok_flash = lcd_model.same(drawn);
+	CHECK(ok_flash);
+
+	memcpy(fram->mem.data() + IMAGE_AT, image, bytes);
+	lcd_clear();
+	i2c_bytes = 0;
+	start = sim_cycles();
+	lcd_stream_fram(&stream, IMAGE_AT, bytes);
+	CHECK(lcd_streamImage(&stream, x, y, 1) == 0);
+	ms_fram = sim_ms(sim_cycles() - start);
+	bus = i2c_bytes;
+	ok_fram = lcd_model.same(drawn);
+	CHECK(ok_fram);
+
+	lcd_clear();						// a row at a time (main loop job)
+	lcd_stream_fram(&stream, IMAGE_AT, bytes);
+	lcd_job_stream(&job, &stream, x, y, 1);
+	while (lcd_job_run(&job, 1)) ++passes;
+	while (i2c_busy()) sim_run(8);		// (bytes past the image)
+	ok_job = lcd_model.same(drawn) && !stream.error;
+	CHECK(ok_job);
+
+	lcd_clear();
+	sim_uart_rx((const uint8_t*)image, bytes);
+	start = sim_cycles();
+	lcd_stream_uart(&stream, bytes);
+	CHECK(lcd_streamImage(&stream, x, y, 1) == 0);
+	ms_uart = sim_ms(sim_cycles() - start);
+	ok_uart = lcd_model.same(drawn);
+	CHECK(ok_uart);
+
+	printf("  %s (%u bytes): flash %s, FRAM %s (%ld bus bytes, %.1f ms),"
+		" FRAM job %s (%ld passes), UART %s (%.1f ms)\n", name,
+		(unsigned)bytes, ok_flash ? "same" : "DIFFERS",
+		ok_fram ? "same" : "DIFFERS", bus, ms_fram,
+		ok_job ? "same" : "DIFFERS", passes + 1,
+		ok_uart ? "same" : "DIFFERS", ms_uart);
+} // end test_sources
+
+
+//******************************************************************************
+//	UART stream cut after half the image: SYS_ERR_UART_TO 250 ms after
+//	the last byte, whatever the loop speed (MCLK 8 and 1 MHz)
+//
+static void test_cut(uint16 kHz)
+{
+	LCD_STREAM stream;
+	uint16 bytes = sizeof(byu1_image);
+	uint64_t start, last;
+	double idle;
+	uint8 error;
+
+	sim_init(kHz);
+	uart_init(kHz == 8000 ? 115200 : 9600);
+	tm_init();
+	__enable_interrupt();
+	lcd_init();
+	lcd_clear();
+	sim_uart_rx((const uint8_t*)byu1_image, bytes / 2);
+	start = sim_cycles();
+	last = start + sim_uart_byte() * (bytes / 2);
+	lcd_stream_uart(&stream, bytes);
+	error = lcd_streamImage(&stream, 20, 100, 1);
+	idle = sim_ms(sim_cycles() - last);
+	CHECK(error == SYS_ERR_UART_TO);
+	CHECK((idle >= 250) && (idle < 252));
+	printf("  UART cut at %u of %u bytes, MCLK %u kHz: error %u after"
+		" %.1f ms idle\n", (unsigned)(bytes / 2), (unsigned)bytes,
+		(unsigned)kHz, (unsigned)error, idle);
+} // end test_cut
+
+
+int main(void)
+{
+	printf("\n");
+	test_sources("byu1", byu1_image, sizeof(byu1_image), 20, 100);
+	test_sources("byu3", byu3_image, sizeof(byu3_image), 35, 130);
+	test_cut(8000);
+	test_cut(1000);
+	return test_done();
+} // end main
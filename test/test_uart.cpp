@@ -0,0 +1,159 @@
+//	test_uart.cpp - RBX430_uart.c against the USCI_A0 model, TXD looped to RXD
+//******************************************************************************
+//******************************************************************************
+//
+#include "sim.h"
+#include "RBX430-1.h"
+#include "RBX430_uart.h"
+
+static const uint8 block_a[] = "<block A>";
+static const uint8 block_b[] = "<block B, a little longer>";
+static uint8 burst[300];
+
+//	read everything received so far
+static std::string uart_drain(void)
+{
+	std::string s;
+	int16 c;
+
+	while ((c = uart_getc()) >= 0) s += (char)c;
+	return s;
+} // end uart_drain
+
+
+//******************************************************************************
+//	baud rate selection and divider
+//
+static void test_init(void)
+{
+	sim_init(8000);
+	CHECK(uart_init(0) == 115200);		// 8 MHz: 69.4 clocks/bit
+	CHECK(UCA0BR0 == 69);
+	CHECK(((UCA0MCTL >> 1) & 7) == 4);	// 69 4/8
+	printf("\n  8 MHz auto baud 115200: UCBR %u UCBRS %u, byte %llu cycles\n",
+		(unsigned)UCA0BR0.v, (unsigned)(UCA0MCTL.v >> 1) & 7,
+		(unsigned long long)sim_uart_byte());
+
+	sim_init(1000);
+	CHECK(uart_init(0) == 9600);
+	sim_init(16000);
+	CHECK(uart_init(0) == 230400);
+} // end test_init
+
+
+//******************************************************************************
+//	ring bytes and zero copy blocks come out in the order they were queued
+//
+static void test_order(void)
+{
+	std::string got, want;
+
+	sim_init(8000);
+	sim_uart_loopback = 1;
+	uart_init(115200);
+	__enable_interrupt();
+
+	uart_puts("abc");
+	uart_send(block_a, sizeof(block_a) - 1);
+	uart_puts("def");
+	uart_send(block_b, sizeof(block_b) - 1);
+	uart_putc('g');
+	want = std::string("abc") + (const char*)block_a + "def"
+		+ (const char*)block_b + "g";
+
+	sim_run(sim_uart_byte() * 16);		// read while it arrives
+	got = uart_drain();
+	while (uart_tx_busy()) sim_run(sim_uart_byte());
+	sim_run(sim_uart_byte() * 2);
+	got += uart_drain();
+
+	CHECK(got == want);
+	CHECK(uart_rx_lost == 0);
+	CHECK(uart_overruns == 0);
+	printf("  putc/send mixed: %u of %u bytes in order, lost %u\n",
+		(unsigned)(got == want ? got.size() : 0), (unsigned)want.size(),
+		(unsigned)uart_rx_lost);
+} // end test_order
+
+
+//******************************************************************************
+//	a block goes out back to back at the baud rate; unread bytes beyond
+//	UART_RX_SIZE - 1 are dropped and counted, the USCI never overruns
+//
+static void test_burst(void)
+{
+	uint64_t start, took;
+	std::string got;
+	int i, ok;
+
+	sim_init(8000);
+	sim_uart_loopback = 1;
+	uart_init(115200);
+	__enable_interrupt();
+	for (i = 0; i < (int)sizeof(burst); ++i) burst[i] = i * 7 + 1;
+
+	start = sim_cycles();
+	uart_send(burst, sizeof(burst));
+	while (uart_tx_busy()) sim_run(8);
+	took = sim_cycles() - start;
+	sim_run(sim_uart_byte() * 2);
+
+	CHECK(uart_rx_count() == UART_RX_SIZE - 1);
+	CHECK(uart_rx_lost == sizeof(burst) - (UART_RX_SIZE - 1));
+	CHECK(uart_overruns == 0);
+	got = uart_drain();
+	for (ok = 1, i = 0; i < (int)got.size(); ++i)
+	{
+		if ((uint8)got[i] != burst[i]) ok = 0;
+	}
+	CHECK(ok);
+	CHECK(took <= (sizeof(burst) + 1) * sim_uart_byte());
+	printf("  300 byte block unread: ring %u, lost %u, USCI overruns %ld,"
+		" %.1f ms (%.1f byte times)\n", (unsigned)got.size(),
+		(unsigned)uart_rx_lost, uart_overruns, sim_ms(took),
+		(double)took / sim_uart_byte());
+} // end test_burst
+
+
+//******************************************************************************
+//	bytes from outside arrive back to back; reading keeps up
+//
+static void test_receive(void)
+{
+	uint8 line[200];
+	std::string got;
+	int i, ok;
+
+	sim_init(8000);
+	uart_init(115200);
+	__enable_interrupt();
+	for (i = 0; i < (int)sizeof(line); ++i) line[i] = 255 - i;
+	sim_uart_rx(line, sizeof(line));
+	for (i = 0; i < 20; ++i)			// read every ~10 byte times
+	{
+		sim_run(sim_uart_byte() * 10);
+		got += uart_drain();
+	}
+	sim_run(sim_uart_byte() * 4);
+	got += uart_drain();
+
+	CHECK(got.size() == sizeof(line));
+	for (ok = 1, i = 0; i < (int)got.size(); ++i)
+	{
+		if ((uint8)got[i] != line[i]) ok = 0;
+	}
+	CHECK(ok);
+	CHECK(uart_rx_lost == 0);
+	printf("  200 bytes in, read every 10 byte times: %u received, lost %u\n",
+		(unsigned)got.size(), (unsigned)uart_rx_lost);
+} // end test_receive
+
+
+int main(void)
+{
+	test_init();
+	test_order();
+	test_burst();
+	test_receive();
+	return test_done();
+} // end main
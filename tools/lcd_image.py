@@ -0,0 +1,672 @@
+#!/usr/bin/env python3
+"""Compile images into RBX430 LCD image tables (lcd_wordImage, lcd_bitImage).
+
+    lcd_image.py logo.png                      (C table to stdout)
+    lcd_image.py logo.pgm -o logo.c --name logo_image
+    lcd_image.py sketch.pbm --bit              (lcd_bitImage table)
+    lcd_image.py lcd_byu_images.c:byu1_image   (re-encode an existing table)
+    lcd_image.py logo.png --pgm check.pgm      (decoded image, 32 grays)
+    lcd_image.py logo.png --pack               (lcd_packImage table)
+    lcd_image.py photo.png --gray              (lcd_grayImage table, dithered)
+    lcd_image.py photo.png --dither            (dithered to the 32 LCD levels)
+
+Input is PGM/PBM (P1-P6), PNG (8 bit or less, not interlaced) or an
+existing C table (file.c:array_name).  Gray levels are scaled to the 32
+LCD levels (0 = black = pixel on); lcd_bitImage turns on pixels darker
+than half gray.  --dither uses ordered (4x4 Bayer) dithering to the
+output's levels instead of rounding; it is the default for --gray.
+
+lcd_wordImage tables are width, height, then rows from the top, each row
+right to left in 2B3P LCD words (3 pixels, the rightmost in bits 0-4).
+The words of all rows form one stream; the decoder (lcd_job_row) reads:
+
+    ccff            cc words of 3 pixels off            (1 word)
+    ccfe            cc words of 3 pixels on             (1 word)
+    ccf0,pppp       cc words of ~pppp                   (2 words)
+    any word with bit 5 clear - written inverted        (1 word)
+
+Runs may continue into the next row.  The encoding is chosen by a
+shortest path search over the word stream: smallest table first, then
+fewest decode cycles (--cycles-per-word trades size for speed).  Decode
+cycles are estimates (MCLK) from the RBX430_lcd_bus.asm loop counts and
+the lcd_job_row decode steps.
+
+lcd_packImage tables (lcd_pack.c) are width, height bytes, then for each
+row from the top, tokens that rebuild the row's LCD words (right to left)
+in a one row buffer that still holds the row above past the current word:
+
+    00nnnnnn w...   n+1 literal words (low byte first)
+    01nnnnnn        n+1 words unchanged from the row above (XOR delta 0)
+    10nnnnnn oo     n+1 words copied from offset oo (signed) - behind is
+                    this row, ahead is the row above (LZ window of 1 row)
+    11nnnnnn        n+1 copies of the word before
+
+Tokens do not cross rows; the row above the image is all off.  The
+encoding is an optimal parse of each row (fewest bytes, then fewest
+decode cycles).
+
+lcd_grayImage tables (lcd_gray.c) are width, height bytes, then for each
+row from the top, the row's LCD words (right to left) as 3 gray levels
+each (0 = off - 15 = on, rightmost pixel first), two levels per byte, low
+nibble first.  Rows start on a byte.  The board maps level L to the LCD
+field 31 - (L * 31 + 7) / 15 by table lookup.
+
+Every table is decoded again by a copy of the board decoder and compared
+with the image before it is written.
+"""
+
+import argparse
+import re
+import struct
+import sys
+import zlib
+
+OFF, ON, MASK = 0xffdf, 0x0000, 0xffdf      # LCD words (bit 5 unused)
+SHIFT = (0, 6, 11)                          # pixel fields, right to left
+
+# decode cycle estimates (MCLK)
+ROW = 300           # LCD_JOB_ROW - window and RAMWR per row
+CALL = 35           # decode loop pass + lcd_write_... call and bus setup
+CODE = 25           # special code switch (+5 for the pattern word)
+BURST = 38          # per literal word (lcd_write_burst_inv + scan)
+SOLID = 16          # per run word, both bytes the same (E strobes only)
+REPEAT = 25         # per run word, other patterns
+BIT_PIXEL = 20      # lcd_bitImage per pixel (mask, test, field clear)
+BIT_WORD = 56       # lcd_bitImage per word (WriteData_word)
+TOKEN = 30          # lcd_packImage token fetch and switch (+ CALL)
+BURST_ONLY = 30     # per word, lcd_write_burst from the row buffer
+LITERAL = 14        # per literal word (2 bytes to the row buffer)
+COPY = 8            # per copied word (+5 for the offset byte)
+FILL = 5            # per repeated word (row buffer store)
+GRAY_DECODE = 24    # lcd_grayImage per word (3 table lookups, nibble split)
+GRAY_WORDS = 8      # lcd_grayImage words per lcd_write_burst
+
+PACK_LITERAL, PACK_ABOVE, PACK_COPY, PACK_REPEAT = 0, 1, 2, 3
+PACK_RUN = 64       # words per token
+BAYER = ((0, 8, 2, 10), (12, 4, 14, 6), (3, 11, 1, 9), (15, 7, 13, 5))
+
+
+# ---------------------------------------------------------------- input
+
+def tokens(data, count):
+    """Return count netpbm header tokens and the offset after them."""
+    out, i = [], 0
+    while len(out) < count:
+        while data[i:i + 1].isspace():
+            i += 1
+        if data[i:i + 1] == b"#":
+            i = data.index(b"\n", i)
+            continue
+        j = i
+        while j < len(data) and not data[j:j + 1].isspace():
+            j += 1
+        out.append(data[i:j])
+        i = j
+    return out, i + 1
+
+
+def read_netpbm(data):
+    """Return (width, height, rows of gray 0-255) from P1-P6."""
+    magic = data[:2]
+    bitmap = magic in (b"P1", b"P4")
+    head, i = tokens(data, 3 if bitmap else 4)
+    width, height = int(head[1]), int(head[2])
+    if magic == b"P4":
+        stride = (width + 7) // 8
+        return width, height, [[0 if data[i + y * stride + (x >> 3)] & (0x80 >> (x & 7))
+                                else 255 for x in range(width)] for y in range(height)]
+    if magic == b"P1":
+        bits = [c for c in data[i - 1:] if c in b"01"]
+        return width, height, [[255 if bits[y * width + x] == 0x30 else 0
+                                for x in range(width)] for y in range(height)]
+    maxval = int(head[3])
+    planes = 3 if magic in (b"P3", b"P6") else 1
+    if magic in (b"P5", b"P6"):
+        size = 2 if maxval > 255 else 1
+        values = [int.from_bytes(data[i + k * size:i + (k + 1) * size], "big")
+                  for k in range(width * height * planes)]
+    else:
+        values = [int(t) for t in data[i - 1:].split()][:width * height * planes]
+    rows = []
+    for y in range(height):
+        row = []
+        for x in range(width):
+            v = values[(y * width + x) * planes:(y * width + x + 1) * planes]
+            g = v[0] if planes == 1 else (v[0] * 299 + v[1] * 587 + v[2] * 114) // 1000
+            row.append(g * 255 // maxval)
+        rows.append(row)
+    return width, height, rows
+
+
+def read_png(data):
+    """Return (width, height, rows of gray 0-255) from a PNG."""
+    pos, idat, palette = 8, b"", None
+    while pos < len(data):
+        size, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        body = data[pos + 8:pos + 8 + size]
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", body)
+        elif kind == b"PLTE":
+            palette = [tuple(body[k:k + 3]) for k in range(0, len(body), 3)]
+        elif kind == b"IDAT":
+            idat += body
+        pos += size + 12
+    if depth > 8 or interlace:
+        sys.exit("PNG: only 8 bit or less, not interlaced")
+    planes = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    bpp = max(1, planes * depth // 8)
+    stride = (width * planes * depth + 7) // 8
+    raw = zlib.decompress(idat)
+    prev = bytearray(stride)
+    rows = []
+    for y in range(height):
+        kind = raw[y * (stride + 1)]
+        line = bytearray(raw[y * (stride + 1) + 1:(y + 1) * (stride + 1)])
+        for k in range(stride):
+            a = line[k - bpp] if k >= bpp else 0
+            b = prev[k]
+            c = prev[k - bpp] if k >= bpp else 0
+            if kind == 1:
+                line[k] = (line[k] + a) & 0xff
+            elif kind == 2:
+                line[k] = (line[k] + b) & 0xff
+            elif kind == 3:
+                line[k] = (line[k] + (a + b) // 2) & 0xff
+            elif kind == 4:
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                line[k] = (line[k] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xff
+        prev = line
+        if depth < 8:
+            per = 8 // depth
+            samples = [(line[x // per] >> (8 - depth * (x % per + 1))) & ((1 << depth) - 1)
+                       for x in range(width)]
+            scale = 255 // ((1 << depth) - 1)
+        else:
+            samples = line
+            scale = 1
+        row = []
+        for x in range(width):
+            v = samples[x * planes:(x + 1) * planes] if depth == 8 else [samples[x]]
+            if color == 3:
+                r, g, b = palette[v[0]]
+                gray = (r * 299 + g * 587 + b * 114) // 1000
+            elif color in (2, 6):
+                gray = (v[0] * 299 + v[1] * 587 + v[2] * 114) // 1000
+            else:
+                gray = v[0] * scale
+            if color in (4, 6):                 # alpha over white
+                alpha = v[-1]
+                gray = (gray * alpha + 255 * (255 - alpha)) // 255
+            row.append(gray)
+        rows.append(row)
+    return width, height, rows
+
+
+def read_table(path, name):
+    """Return the numbers of C array name in path."""
+    text = re.sub(r"//[^\n]*|/\*.*?\*/", "", open(path).read(), flags=re.S)
+    m = re.search(r"\b%s\s*\[\s*\]\s*=\s*\{(.*?)\}" % re.escape(name), text, re.S)
+    if not m:
+        sys.exit("%s: no table %s" % (path, name))
+    return [int(t, 0) for t in m.group(1).replace(",", " ").split()]
+
+
+def read_image(name):
+    """Return (width, height, rows of gray 0-255) from a file or table."""
+    if ":" in name and name.split(":")[0].endswith(".c"):
+        path, table = name.rsplit(":", 1)
+        width, height, words, _, _ = decode_word_image(read_table(path, table))
+        return width, height, [[g * 255 // 31 for g in row]
+                               for row in words_to_grays(words, width)]
+    data = open(name, "rb").read()
+    if data[:8] == b"\x89PNG\r\n\x1a\n":
+        width, height, rows = read_png(data)
+    elif data[:1] == b"P":
+        width, height, rows = read_netpbm(data)
+    else:
+        sys.exit("%s: not a PGM/PBM/PNG image" % name)
+    return width, height, rows
+
+
+def quantize(rows, levels, dither):
+    """Return rows of gray 0-255 as levels 0 (black) - levels - 1, rounded or
+    ordered dithered (4x4 Bayer thresholds)."""
+    if not dither:
+        return [[(g * (levels - 1) + 127) // 255 for g in row] for row in rows]
+    return [[min(levels - 1, int(g * (levels - 1) / 255.0 + (BAYER[y & 3][x & 3] + 0.5) / 16))
+             for x, g in enumerate(row)] for y, row in enumerate(rows)]
+
+
+# ---------------------------------------------------------------- pixels
+
+def grays_to_words(rows, width):
+    """Return rows of LCD words, right to left (left pixels past the image off)."""
+    out = []
+    for row in rows:
+        words = []
+        for j in range((width + 2) // 3):
+            word = 0
+            for k in range(3):
+                x = width - 1 - 3 * j - k
+                word |= (row[x] if x >= 0 else 31) << SHIFT[k]
+            words.append(word)
+        out.append(words)
+    return out
+
+
+def words_to_grays(rows, width):
+    """Return rows of gray 0-31 from rows of LCD words (right to left)."""
+    return [[(words[(width - 1 - x) // 3] >> SHIFT[(width - 1 - x) % 3]) & 0x1f
+             for x in range(width)] for words in rows]
+
+
+def solid(word):
+    """lcd_write_repeat strobes only when both bytes match (but bit 5)."""
+    return ((word >> 8) ^ word) & 0xdf == 0
+
+
+# ---------------------------------------------------------------- lcd_wordImage
+
+def decode_word_image(table):
+    """Board decoder (lcd_job_row) - return (width, height, rows, cycles, used)."""
+    width, height = table[0], table[1]
+    per_row = (width + 2) // 3
+    i, run, pixels, cycles, rows = 2, 0, OFF, 0, []
+    for _ in range(height):
+        row, x1 = [], per_row
+        cycles += ROW
+        while x1 > 0:
+            if run:
+                n = min(run, x1)
+                row += [pixels] * n
+                run -= n
+                x1 -= n
+                cycles += CALL + n * (SOLID if solid(pixels) else REPEAT)
+                continue
+            word = table[i]
+            i += 1
+            if word & 0x0020:
+                low = word & 0xff
+                if low == 0xff:
+                    pixels = OFF
+                elif low == 0xfe:
+                    pixels = ON
+                else:
+                    pixels = ~table[i] & 0xffff
+                    i += 1
+                    cycles += 5
+                run = word >> 8
+                cycles += CODE
+                continue
+            n = 1
+            while n < x1 and not table[i - 1 + n] & 0x0020:
+                n += 1
+            row += [~w & 0xffff for w in table[i - 1:i - 1 + n]]
+            i += n - 1
+            x1 -= n
+            cycles += CALL + n * BURST
+        rows.append(row)
+    return width, height, rows, cycles, i
+
+
+def encode_word_image(words, cycles_per_word):
+    """Return the smallest (then fastest) word stream for rows of LCD words."""
+    per_row = len(words[0])
+    stream = [w for row in words for w in row]
+    n_words = len(stream)
+    same = [1] * (n_words + 1)                  # equal words from i
+    for i in range(n_words - 2, -1, -1):
+        if (stream[i] ^ stream[i + 1]) & MASK == 0:
+            same[i] = same[i + 1] + 1
+    inf = float("inf")
+    # cost[i][open] - open: a literal burst is running into word i
+    cost = [[inf, inf] for _ in range(n_words + 1)]
+    back = [[None, None] for _ in range(n_words + 1)]
+    cost[0][0] = 0
+    for i in range(n_words):
+        for state in (0, 1):
+            base = cost[i][state]
+            if base == inf:
+                continue
+            # literal word (burst call only when a burst starts)
+            nxt = 1 if (i + 1) % per_row else 0
+            c = base + cycles_per_word + BURST + (0 if state else CALL)
+            if c < cost[i + 1][nxt]:
+                cost[i + 1][nxt] = c
+                back[i + 1][nxt] = (i, state, 0)
+            # run of n equal words
+            word = stream[i]
+            size = 1 if word & MASK in (OFF, ON) else 2
+            per = SOLID if solid(word) else REPEAT
+            for n in range(1, min(255, same[i]) + 1):
+                splits = (i % per_row + n - 1) // per_row + 1
+                c = (base + size * cycles_per_word + CODE + 5 * (size - 1)
+                     + splits * CALL + n * per)
+                if c < cost[i + n][0]:
+                    cost[i + n][0] = c
+                    back[i + n][0] = (i, state, n)
+    out, i, state = [], n_words, 0
+    if cost[n_words][1] < cost[n_words][0]:
+        state = 1
+    while i:
+        j, prev, n = back[i][state]
+        if n == 0:
+            out.append(~stream[j] & MASK)       # literal (bit 5 clear)
+        elif stream[j] & MASK == OFF:
+            out.append(n << 8 | 0xff)
+        elif stream[j] & MASK == ON:
+            out.append(n << 8 | 0xfe)
+        else:
+            out += [~stream[j] & 0xffff, n << 8 | 0xf0]
+        i, state = j, prev
+    return out[::-1]
+
+
+def check_word_image(table, words):
+    width, height, rows, cycles, used = decode_word_image(table)
+    bad = sum((a ^ b) & MASK != 0 for ra, rb in zip(rows, words) for a, b in zip(ra, rb))
+    if bad or used != len(table):
+        sys.exit("round trip failed: %d words differ, %d of %d table words used"
+                 % (bad, used, len(table)))
+    return cycles
+
+
+# ---------------------------------------------------------------- lcd_bitImage
+
+def encode_bit_image(rows, width):
+    """Return lcd_bitImage bytes (width padded to 8 with off pixels)."""
+    padded = (width + 7) // 8 * 8
+    table = [padded, len(rows)]
+    for row in rows:
+        bits = [1 if x < width and row[x] < 16 else 0 for x in range(padded)]
+        table += [sum(bits[b + k] << (7 - k) for k in range(8)) for b in range(0, padded, 8)]
+    return table
+
+
+def decode_bit_image(table):
+    """Board decoder (lcd_bitImage flag 1) - return (rows of words, cycles)."""
+    width, height = table[0], table[1]
+    image, rows, cycles = 2, [], 0
+    for _ in range(height):
+        image += width >> 3
+        mask, data, index, row, bits = 0x80, OFF, 0, [], 0
+        for _ in range(width):
+            mask = (mask << 1) & 0xff
+            if mask == 0:
+                mask = 0x01
+                image -= 1
+                bits = table[image]
+            if bits & mask:
+                data &= (0xffe0, 0xf83f, 0x07df)[index]
+            index += 1
+            if index == 3:
+                row.append(data)
+                data, index = OFF, 0
+        if index:
+            row.append(data)
+        image += width >> 3
+        rows.append(row)
+        cycles += ROW + width * BIT_PIXEL + len(row) * BIT_WORD
+    return rows, cycles
+
+
+# ---------------------------------------------------------------- lcd_packImage
+
+def runs(equal, size):
+    """Return run[j] = number of True equal(k) from k = j on."""
+    run = [0] * (size + 1)
+    for j in range(size - 1, -1, -1):
+        run[j] = run[j + 1] + 1 if equal(j) else 0
+    return run
+
+
+def encode_pack_row(row, above, cycles_per_byte):
+    """Return the token bytes for one row (optimal parse)."""
+    size = len(row)
+    same = runs(lambda j: row[j] == above[j], size)
+    repeat = runs(lambda j: j > 0 and row[j] == row[j - 1], size)
+    copy = [(0, 0)] * (size + 1)                # (length, offset) longest
+    for off in list(range(-size + 1, -1)) + list(range(1, size)):
+        src = above if off > 0 else row
+        run = runs(lambda j: 0 <= j + off < size and row[j] == src[j + off], size)
+        for j in range(size):
+            if run[j] > copy[j][0]:
+                copy[j] = (run[j], off)
+    inf = float("inf")
+    cost = [0] + [inf] * size
+    back = [None] * (size + 1)
+    for j in range(size):
+        if cost[j] == inf:
+            continue
+
+        def step(n, kind, nbytes, cycles):
+            c = cost[j] + nbytes * cycles_per_byte + TOKEN + CALL + cycles
+            if c < cost[j + n]:
+                cost[j + n] = c
+                back[j + n] = (j, kind, n)
+
+        for n in range(1, min(PACK_RUN, size - j) + 1):
+            step(n, PACK_LITERAL, 1 + 2 * n, n * (LITERAL + BURST_ONLY))
+            if n <= same[j]:
+                step(n, PACK_ABOVE, 1, n * BURST_ONLY)
+            if n <= repeat[j]:
+                step(n, PACK_REPEAT, 1, n * (FILL + (SOLID if solid(row[j - 1]) else REPEAT)))
+            if n <= copy[j][0]:
+                step(n, PACK_COPY, 2, 5 + n * (COPY + BURST_ONLY))
+    tokens, j = [], size
+    while j:
+        j, kind, n = back[j]
+        code = [kind << 6 | (n - 1)]
+        if kind == PACK_LITERAL:
+            for w in row[j:j + n]:
+                code += [w & 0xff, w >> 8]
+        elif kind == PACK_COPY:
+            code.append(copy[j][1] & 0xff)
+        tokens.append(code)
+    return [b for code in reversed(tokens) for b in code]
+
+
+def encode_pack_image(words, cycles_per_byte):
+    """Return lcd_packImage bytes (without width, height)."""
+    out, above = [], [OFF] * len(words[0])
+    for row in words:
+        row = [w & MASK for w in row]
+        out += encode_pack_row(row, above, cycles_per_byte)
+        above = row
+    return out
+
+
+def decode_pack_image(table):
+    """Board decoder (lcd_packImage) - return (width, height, rows, cycles, used)."""
+    width, height = table[0], table[1]
+    size = (width + 2) // 3
+    buf, i, rows, cycles = [OFF] * size, 2, [], 0
+    for _ in range(height):
+        j = 0
+        cycles += ROW
+        while j < size:
+            code = table[i]
+            i += 1
+            kind, n = code >> 6, (code & 0x3f) + 1
+            cycles += TOKEN + CALL
+            if kind == PACK_LITERAL:
+                for k in range(n):
+                    buf[j + k] = table[i] | table[i + 1] << 8
+                    i += 2
+                cycles += n * (LITERAL + BURST_ONLY)
+            elif kind == PACK_ABOVE:
+                cycles += n * BURST_ONLY
+            elif kind == PACK_COPY:
+                off = table[i] - 256 if table[i] > 127 else table[i]
+                i += 1
+                for k in range(n):
+                    buf[j + k] = buf[j + k + off]
+                cycles += 5 + n * (COPY + BURST_ONLY)
+            else:
+                for k in range(n):
+                    buf[j + k] = buf[j - 1]
+                cycles += n * (FILL + (SOLID if solid(buf[j - 1]) else REPEAT))
+            j += n
+        if j != size:
+            sys.exit("lcd_packImage: token past the end of a row")
+        rows.append(list(buf))
+    return width, height, rows, cycles, i
+
+
+# ---------------------------------------------------------------- lcd_grayImage
+
+def gray_field(level):
+    """LCD field of gray level 0 (off) - 15 (on) - lcd_gray_pix."""
+    return 31 - (level * 31 + 7) // 15
+
+
+def encode_gray_image(rows, width):
+    """Return lcd_grayImage bytes from rows of gray level 0 (off) - 15 (on)."""
+    table = [width, len(rows)]
+    for row in rows:
+        levels = []
+        for j in range((width + 2) // 3):
+            for k in range(3):
+                x = width - 1 - 3 * j - k
+                levels.append(row[x] if x >= 0 else 0)
+        levels.append(0)                    # (odd word count - half byte)
+        table += [levels[i] | levels[i + 1] << 4 for i in range(0, len(levels) - 1, 2)]
+    return table
+
+
+def decode_gray_image(table):
+    """Board decoder (lcd_grayImage) - return (width, height, rows, cycles, used)."""
+    width, height = table[0], table[1]
+    words = (width + 2) // 3
+    pix = [[gray_field(level) << SHIFT[k] for level in range(16)] for k in range(3)]
+    image, rows, cycles = 2, [], 0
+    for _ in range(height):
+        row = []
+        for j in range(words, 0, -2):
+            if j > 1:
+                b0, b1, b2 = table[image:image + 3]
+                image += 3
+                row.append(pix[0][b0 & 0x0f] | pix[1][b0 >> 4] | pix[2][b1 & 0x0f])
+                row.append(pix[0][b1 >> 4] | pix[1][b2 & 0x0f] | pix[2][b2 >> 4])
+            else:
+                b0, b1 = table[image:image + 2]
+                image += 2
+                row.append(pix[0][b0 & 0x0f] | pix[1][b0 >> 4] | pix[2][b1 & 0x0f])
+        rows.append(row)
+        cycles += ROW + words * (GRAY_DECODE + BURST_ONLY) + \
+            (words + GRAY_WORDS - 1) // GRAY_WORDS * CALL
+    return width, height, rows, cycles, image
+
+
+# ---------------------------------------------------------------- output
+
+def c_table(kind, name, width, height, values, comment):
+    fmt = "0x%04x" if kind == "uint16" else "0x%02x"
+    lines = ["//\t%s\n" % comment,
+             "const %s %s[] = { %d, %d,\n" % (kind, name, width, height)]
+    body = values[2:]
+    for k in range(0, len(body), 8):
+        lines.append("  " + ",".join(fmt % v for v in body[k:k + 8]) + ",\n")
+    lines.append("};\n")
+    return "".join(lines)
+
+
+def write_pgm(path, rows):
+    with open(path, "wb") as f:
+        f.write(b"P5\n%d %d\n31\n" % (len(rows[0]), len(rows)))
+        f.write(bytes(v for row in rows for v in row))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("input", help="image (.pgm/.pbm/.png) or file.c:table")
+    ap.add_argument("-o", "--output", help="C file (default stdout)")
+    ap.add_argument("--name", help="array name (default from the input)")
+    ap.add_argument("--bit", action="store_true", help="lcd_bitImage table")
+    ap.add_argument("--pack", action="store_true", help="lcd_packImage table")
+    ap.add_argument("--gray", action="store_true", help="lcd_grayImage table (4 bpp)")
+    ap.add_argument("--dither", action=argparse.BooleanOptionalAction,
+                    help="ordered dithering (default: only for --gray)")
+    ap.add_argument("--cycles-per-word", type=int, default=1000000,
+                    help="decode cycles one table word is worth (default: size first)")
+    ap.add_argument("--pgm", help="write the decoded table as a PGM")
+    args = ap.parse_args()
+
+    width, height, pixels = read_image(args.input)
+    dither = args.gray if args.dither is None else args.dither
+    grays = quantize(pixels, 2 if args.bit and dither else 32, dither)
+    if args.bit and dither:
+        grays = [[31 * g for g in row] for row in grays]
+    name = args.name or re.sub(r"\W", "_", re.split(r"[/:]", args.input)[-1].rsplit(".", 1)[0])
+    if not name.endswith("_image"):
+        name += "_image"
+    words = grays_to_words(grays, width)
+    raw = len(words[0]) * height
+
+    if args.gray:
+        levels = [[15 - g for g in row] for row in quantize(pixels, 16, dither)]
+        table = encode_gray_image(levels, width)
+        _, _, rows, cycles, used = decode_gray_image(table)
+        expect = grays_to_words([[gray_field(level) for level in row] for row in levels], width)
+        if used != len(table) or any((a ^ b) & MASK for ra, rb in zip(rows, expect)
+                                     for a, b in zip(ra, rb)):
+            sys.exit("round trip failed: lcd_grayImage")
+        text = c_table("uint8", name, width, height, table,
+                       "lcd_grayImage(%s, x, y);\t// %d x %d, %d bytes"
+                       % (name, width, height, len(table)))
+        decoded = words_to_grays(rows, width)
+        size = "%d bytes (%d levels%s)" % (len(table), len({g for row in levels for g in row}),
+                                           ", dithered" if dither else "")
+    elif args.pack:
+        table = [width, height] + encode_pack_image(words, args.cycles_per_word // 2)
+        _, _, rows, cycles, used = decode_pack_image(table)
+        if used != len(table) or any((a ^ b) & MASK for ra, rb in zip(rows, words)
+                                     for a, b in zip(ra, rb)):
+            sys.exit("round trip failed: lcd_packImage")
+        text = c_table("uint8", name, width, height, table,
+                       "lcd_packImage(%s, x, y);\t// %d x %d, %d bytes"
+                       % (name, width, height, len(table)))
+        decoded = words_to_grays(rows, width)
+        rle = [width, height] + encode_word_image(words, args.cycles_per_word)
+        size = "%d bytes (lcd_wordImage %d bytes, ~%d cycles)" % (
+            len(table), 2 * len(rle), decode_word_image(rle)[3])
+    elif args.bit:
+        table = encode_bit_image(grays, width)
+        rows, cycles = decode_bit_image(table)
+        padded = table[0]
+        expect = grays_to_words([[0 if x < width and row[x] < 16 else 31
+                                  for x in range(padded)] for row in grays], padded)
+        if any((a ^ b) & MASK for ra, rb in zip(rows, expect) for a, b in zip(ra, rb)):
+            sys.exit("round trip failed: lcd_bitImage")
+        text = c_table("uint8", name, table[0], height, table,
+                       "lcd_bitImage(%s, x, y, 1);\t// %d x %d, %d bytes"
+                       % (name, table[0], height, len(table)))
+        decoded = words_to_grays(rows, table[0])
+        size = "%d bytes" % len(table)
+    else:
+        table = [width, height] + encode_word_image(words, args.cycles_per_word)
+        cycles = check_word_image(table, words)
+        text = c_table("uint16", name, width, height, table,
+                       "lcd_wordImage(%s, x, y, 1);\t// %d x %d, %d words"
+                       % (name, width, height, len(table)))
+        decoded = words_to_grays(decode_word_image(table)[2], width)
+        size = "%d words (%d bytes, %.0f%% of %d raw)" % (
+            len(table), 2 * len(table), 100.0 * (len(table) - 2) / raw, raw)
+
+    if args.output:
+        open(args.output, "w").write(text)
+    else:
+        sys.stdout.write(text)
+    if args.pgm:
+        write_pgm(args.pgm, decoded)
+    msg = "%s: %d x %d, %s, ~%d decode cycles (~%.1f ms @8MHz), round trip ok" % (
+        name, width, height, size, cycles, cycles / 8000.0)
+    if ":" in args.input and not (args.bit or args.pack or args.gray):
+        old = read_table(*args.input.rsplit(":", 1))
+        msg += "\n  was %d words, ~%d decode cycles" % (len(old), decode_word_image(old)[3])
+    print(msg, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
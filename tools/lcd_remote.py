@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+"""Draw on the RBX430 LCD from a PC (remote display, lcd_remote.c).
+
+Each command is one COBS frame between 0x00 delimiters:
+    command, sequence, arguments, CRC-16/CCITT (low byte first)
+and the board replies with status, sequence, CRC-16 when it is done.
+A frame with a bad reply (or none within --timeout) is sent again.
+Telemetry frames on the same port are skipped.
+
+    lcd_remote.py /dev/ttyUSB0 clear                   (needs pyserial)
+    lcd_remote.py /dev/ttyUSB0 fill 10 10 40 20        (x, y = lower left)
+    lcd_remote.py /dev/ttyUSB0 fill 10 10 40 20 --off
+    lcd_remote.py /dev/ttyUSB0 text 0 150 "Hello"
+    lcd_remote.py /dev/ttyUSB0 image photo.pgm         (P5/P2 160x160 max)
+    lcd_remote.py frames.bin image photo.pgm           (write frames only)
+
+Images are sent as 2B3P LCD words (32 gray levels, 3 pixels per word) to
+RAM lines, top row at --top (159) and left column at --left (rounded to
+a 3 pixel word), in frames of --lines rows.  The board writes each word
+as it arrives, so a blit runs at about the baud rate; the reply after
+each frame costs one round trip.  RAM lines are display rows only while
+the display is not scrolled.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+from telemetry import cobs_decode, crc16
+
+RD_CLEAR, RD_FILL, RD_BLIT, RD_TEXT = 1, 2, 3, 4
+RD_STATUS = {0x80: "ok", 0x81: "CRC error", 0x82: "bad command",
+             0x83: "bytes lost"}
+RD_TEXT_SIZE = 27
+LCD_WORDS, LCD_LINES = 54, 160
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for b in data:
+        if b == 0:
+            out += bytes([len(block) + 1]) + block
+            block = bytearray()
+            continue
+        block.append(b)
+        if len(block) == 0xfe:
+            out += b"\xff" + block
+            block = bytearray()
+    out += bytes([len(block) + 1]) + block
+    return bytes(out)
+
+
+def frame(cmd, seq, payload=b""):
+    body = bytes([cmd, seq & 0xff]) + payload
+    return b"\x00" + cobs_encode(body + struct.pack("<H", crc16(body))) + b"\x00"
+
+
+def read_pgm(name):
+    """Return (width, height, rows of gray 0-31) from a P5 or P2 PGM."""
+    data = open(name, "rb").read()
+    tokens = []
+    i = 0
+    while len(tokens) < 4:
+        while data[i:i + 1].isspace():
+            i += 1
+        if data[i:i + 1] == b"#":
+            i = data.index(b"\n", i)
+            continue
+        j = i
+        while not data[j:j + 1].isspace():
+            j += 1
+        tokens.append(data[i:j])
+        i = j
+    magic, width, height, maxval = tokens[0], int(tokens[1]), int(tokens[2]), int(tokens[3])
+    if magic == b"P5":
+        pixels = data[i + 1:i + 1 + width * height]
+    elif magic == b"P2":
+        pixels = [int(t) for t in data[i:].split()][:width * height]
+    else:
+        sys.exit("%s: not a PGM (P5/P2) image" % name)
+    if len(pixels) < width * height:
+        sys.exit("%s: image data short" % name)
+    rows = [[(pixels[y * width + x] * 31 + maxval // 2) // maxval for x in range(width)]
+            for y in range(height)]
+    return width, height, rows
+
+
+def blit_frames(rows, left, top, lines_per_frame):
+    """Yield (cmd, payload) blit commands for an image at left, top."""
+    width = len(rows[0])
+    first = (159 - left - (width - 1)) // 3
+    last = (159 - left) // 3
+    first, last = max(first, 0), min(last, LCD_WORDS - 1)
+    words = last - first + 1
+    for y0 in range(0, len(rows), lines_per_frame):
+        chunk = rows[y0:y0 + lines_per_frame]
+        data = bytearray()
+        for row in chunk:
+            fields = [31] * (LCD_WORDS * 3)
+            for x, gray in enumerate(row):
+                p = 159 - (left + x)
+                if 0 <= p < len(fields):
+                    fields[p] = gray
+            for w in range(first, last + 1):
+                word = (fields[3 * w] | (fields[3 * w + 1] << 6)
+                        | (fields[3 * w + 2] << 11))
+                data += struct.pack(">H", word)
+        # RAM lines ascend; the chunk's bottom row is the lowest line
+        bottom = top - (y0 + len(chunk) - 1)
+        if bottom < 0:
+            return
+        ordered = bytearray()
+        n = words * 2
+        for i in range(len(chunk) - 1, -1, -1):
+            ordered += data[i * n:(i + 1) * n]
+        yield RD_BLIT, bytes([first, bottom, words, len(chunk)]) + bytes(ordered)
+
+
+class Link:
+    def __init__(self, name, baud, timeout, retries):
+        self.seq = 0
+        self.timeout = timeout
+        self.retries = retries
+        if not os.path.exists(name) or os.path.isfile(name):
+            self.out = open(name, "wb")     # frames only, no replies
+            self.port = None
+            return
+        try:
+            import serial
+        except ImportError:
+            sys.exit("pyserial is needed to open %s (pip install pyserial)" % name)
+        self.port = serial.Serial(name, baud, timeout=0.05)
+        self.buf = bytearray()
+
+    def reply(self, deadline):
+        """Return the next decoded reply frame (None on timeout)."""
+        while time.time() < deadline:
+            data = self.port.read(64)
+            for b in data:
+                if b:
+                    self.buf.append(b)
+                    continue
+                raw, self.buf = bytes(self.buf), bytearray()
+                try:
+                    msg = cobs_decode(raw)
+                except ValueError:
+                    continue
+                if (len(msg) == 4 and msg[0] in RD_STATUS
+                        and crc16(msg[:2]) == struct.unpack("<H", msg[2:])[0]):
+                    return msg          # (telemetry frames fail this)
+        return None
+
+    def send(self, cmd, payload=b""):
+        self.seq = (self.seq + 1) & 0xff
+        data = frame(cmd, self.seq, payload)
+        if self.port is None:
+            self.out.write(data)
+            return
+        for _ in range(self.retries + 1):
+            self.port.write(data)
+            deadline = time.time() + self.timeout + len(data) * 10.0 / self.port.baudrate
+            while True:
+                msg = self.reply(deadline)
+                if msg is None or msg[1] == self.seq:
+                    break               # (late replies to old frames skipped)
+            if msg is None:
+                print("no reply - sending again", file=sys.stderr)
+                continue
+            if msg[0] == 0x80:
+                return
+            if msg[0] == 0x82:
+                sys.exit("board: bad command (frame %d)" % self.seq)
+            print("board: %s - sending again" % RD_STATUS[msg[0]], file=sys.stderr)
+        sys.exit("giving up after %d tries" % (self.retries + 1))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("port", help="serial port (or a file to write frames to)")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--timeout", type=float, default=0.5, help="reply wait (s)")
+    ap.add_argument("--retries", type=int, default=3)
+    sub = ap.add_subparsers(dest="cmd", required=True)
+    sub.add_parser("clear")
+    p = sub.add_parser("fill")
+    for a in ("x", "y", "w", "h"):
+        p.add_argument(a, type=int)
+    p.add_argument("--off", action="store_true", help="blank (default fill)")
+    p = sub.add_parser("text")
+    p.add_argument("x", type=int)
+    p.add_argument("y", type=int)
+    p.add_argument("text")
+    p = sub.add_parser("image")
+    p.add_argument("pgm")
+    p.add_argument("--left", type=int, default=0)
+    p.add_argument("--top", type=int, default=159)
+    p.add_argument("--lines", type=int, default=20, help="rows per frame")
+    args = ap.parse_args()
+
+    link = Link(args.port, args.baud, args.timeout, args.retries)
+    start = time.time()
+    sent = 0
+    if args.cmd == "clear":
+        link.send(RD_CLEAR)
+    elif args.cmd == "fill":
+        link.send(RD_FILL, bytes([args.x, args.y, args.w, args.h, 0 if args.off else 1]))
+    elif args.cmd == "text":
+        text = args.text.encode("ascii", "replace")
+        if len(text) > RD_TEXT_SIZE:
+            sys.exit("text is %d characters (%d max)" % (len(text), RD_TEXT_SIZE))
+        link.send(RD_TEXT, bytes([args.x, args.y]) + text)
+    else:
+        width, height, rows = read_pgm(args.pgm)
+        if width > 160 or height > 160:
+            sys.exit("%s: image is %dx%d (160x160 max)" % (args.pgm, width, height))
+        for cmd, payload in blit_frames(rows, args.left, args.top, args.lines):
+            link.send(cmd, payload)
+            sent += len(payload)
+        elapsed = time.time() - start
+        if link.port is not None and elapsed > 0:
+            print("%d bytes in %.2fs (%.0f bytes/s, baud limit %d)"
+                  % (sent, elapsed, sent / elapsed, args.baud // 10), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
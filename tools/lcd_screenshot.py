@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Receive an RBX430 LCD screenshot (lcd_screenshot) over a serial port.
+
+The board sends a binary PGM (P5, 160x160, maxval 31) or PBM (P4) image.
+Bytes before the header are skipped, so the receiver can be started
+before or after the screenshot is triggered.
+
+    lcd_screenshot.py /dev/ttyUSB0 shot.png            (needs pyserial)
+    lcd_screenshot.py /dev/ttyUSB0 shot.pgm --baud 230400
+    lcd_screenshot.py capture.bin shot.png             (saved capture)
+
+The output format follows the file extension: .pgm/.pbm keep the image
+as sent, .png is an 8-bit grayscale PNG (PGM levels 0-31 scaled to 0-255).
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+
+def open_input(name, baud, timeout):
+    """Return a read(n) function for a serial port or a capture file."""
+    if name == "-":
+        return sys.stdin.buffer.read
+    if os.path.isfile(name):
+        return open(name, "rb").read
+    try:
+        import serial
+    except ImportError:
+        sys.exit("pyserial is needed to read %s (pip install pyserial)" % name)
+    port = serial.Serial(name, baud, timeout=timeout)
+    return port.read
+
+
+def read_token(read):
+    """Read one whitespace separated header token."""
+    token = b""
+    while True:
+        c = read(1)
+        if not c:
+            raise EOFError("stream ended in header")
+        if c.isspace():
+            if token:
+                return token
+        else:
+            token += c
+
+
+def receive(read):
+    """Skip to the P5/P4 magic and return (magic, width, height, maxval, data)."""
+    last = b""
+    while True:
+        c = read(1)
+        if not c:
+            raise EOFError("no screenshot header received")
+        if last == b"P" and c in b"45":
+            break
+        last = c
+    magic = b"P" + c
+    width = int(read_token(read))
+    height = int(read_token(read))
+    maxval = 1 if magic == b"P4" else int(read_token(read))
+    size = (width + 7) // 8 * height if magic == b"P4" else width * height
+    data = b""
+    while len(data) < size:
+        chunk = read(size - len(data))
+        if not chunk:
+            raise EOFError("stream ended after %d of %d bytes" % (len(data), size))
+        data += chunk
+    return magic, width, height, maxval, data
+
+
+def gray_rows(magic, width, height, maxval, data):
+    """Yield rows of 8-bit gray values (0 = black)."""
+    if magic == b"P4":
+        stride = (width + 7) // 8
+        for y in range(height):
+            row = data[y * stride:(y + 1) * stride]
+            yield bytes(0 if row[x >> 3] & (0x80 >> (x & 7)) else 255
+                        for x in range(width))
+    else:
+        for y in range(height):
+            row = data[y * width:(y + 1) * width]
+            yield bytes(v * 255 // maxval for v in row)
+
+
+def write_png(path, width, height, rows):
+    def chunk(kind, body):
+        return (struct.pack(">I", len(body)) + kind + body
+                + struct.pack(">I", zlib.crc32(kind + body) & 0xffffffff))
+    raw = b"".join(b"\x00" + row for row in rows)
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 0, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(raw, 9)))
+        f.write(chunk(b"IEND", b""))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("input", help="serial port, capture file or - for stdin")
+    ap.add_argument("output", help="image file (.pgm, .pbm or .png)")
+    ap.add_argument("--baud", type=int, default=115200,
+                    help="serial baud rate (uart_init default at 8/12MHz)")
+    ap.add_argument("--timeout", type=float, default=10.0,
+                    help="serial read timeout (seconds)")
+    args = ap.parse_args()
+
+    magic, width, height, maxval, data = receive(
+        open_input(args.input, args.baud, args.timeout))
+    if args.output.lower().endswith(".png"):
+        write_png(args.output, width, height,
+                  gray_rows(magic, width, height, maxval, data))
+    else:
+        with open(args.output, "wb") as f:
+            f.write(magic + b"\n%d %d\n" % (width, height))
+            if magic == b"P5":
+                f.write(b"%d\n" % maxval)
+            f.write(data)
+    print("%s %dx%d -> %s" % (magic.decode(), width, height, args.output))
+
+
+if __name__ == "__main__":
+    main()
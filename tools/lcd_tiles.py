@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""Build lcd_tile.c tile sets of font characters (6x8 tiles).
+
+    lcd_tiles.py ../Simon/RBX430_lcd.c " 0123456789" -o digits.c
+    lcd_tiles.py ../Simon/RBX430_lcd.c "-0123456789CDEHILNORSU" --name simon_tiles
+
+The 5x8 font is the cs[][5] table of an RBX430_lcd.c (one byte per
+column, bit 7 = top line).  A tile is a blank column and the 5 glyph
+columns.  lcd_putchar draws its leading blank and the first glyph column
+at the same x, so a character is 5 glyph columns and a blank: a row of
+tiles is what lcd_printf draws with the cursor one pixel right of the
+first tile's blank column.  Tiles are TILE_WORDS 2B3P words: lines top first, each line the
+right word then the left word (lcd_tile_flush order).  Tile n is the n-th
+character of the list.
+"""
+
+import argparse
+import re
+import sys
+
+OFF = 0xffdf                                # 2B3P word, 3 pixels off
+FIELD = (0xf800, 0x07c0, 0x001f)            # pixels left to right
+
+
+def read_font(path):
+    """Return the cs[][5] font of path (list of 5 column bytes from ' ')."""
+    text = re.sub(r"//[^\n]*|/\*.*?\*/", "", open(path).read(), flags=re.S)
+    m = re.search(r"\bcs\s*\[\s*\]\s*\[\s*5\s*\]\s*=\s*\{(.*?)\};", text, re.S)
+    if not m:
+        sys.exit("%s: no cs[][5] font" % path)
+    return [[int(v, 0) for v in glyph.replace(",", " ").split()]
+            for glyph in re.findall(r"\{([^}]*)\}", m.group(1))]
+
+
+def w2b3p(pixels):
+    """W2B3P - LCD word of 3 pixels (left to right, 1 = on)."""
+    word = OFF
+    for on, field in zip(pixels, FIELD):
+        if on:
+            word &= ~field & 0xffff
+    return word
+
+
+def tile(glyph):
+    """Return the TILE_WORDS words of a glyph (blank column first)."""
+    words = []
+    for line in range(8):
+        px = [0] + [(col >> (7 - line)) & 1 for col in glyph]
+        words += [w2b3p(px[3:6]), w2b3p(px[0:3])]
+    return words
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("font", help="RBX430_lcd.c with the cs[][5] font")
+    ap.add_argument("chars", help="characters, in tile order")
+    ap.add_argument("-o", "--output", help="C file (default stdout)")
+    ap.add_argument("--name", default="font_tiles", help="array name")
+    args = ap.parse_args()
+
+    font = read_font(args.font)
+    lines = ["//\ttile set for lcd_tile_init - tools/lcd_tiles.py \"%s\"\n" % args.chars,
+             "const uint16 %s[] = {\n" % args.name]
+    for n, c in enumerate(args.chars):
+        if not " " <= c < chr(0x20 + len(font)):
+            sys.exit("no glyph for %r" % c)
+        words = tile(font[ord(c) - 0x20])
+        lines.append("  // %d '%s'\n" % (n, c))
+        for k in range(0, len(words), 8):
+            lines.append("  " + ",".join("0x%04x" % w for w in words[k:k + 8]) + ",\n")
+    lines.append("};\n")
+    text = "".join(lines)
+    if args.output:
+        open(args.output, "w").write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Decode RBX430 telemetry frames (RBX430_telemetry.c) to CSV.
+
+Frames are COBS encoded between 0x00 delimiters.  Each frame holds the
+channels changed since the last one; the CSV has one row per frame with
+the channels that were sent (other cells are empty).  Time channels are
+converted from Timer A ticks to microseconds with the ticks/ms value in
+each frame.  Frames with a bad CRC (line noise, screenshot bytes) are
+counted and skipped.
+
+    telemetry.py /dev/ttyUSB0 run.csv             (needs pyserial, ^C stops)
+    telemetry.py capture.bin run.csv
+    telemetry.py capture.bin - --channels 0=left,4=loop:us
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+
+# Etch-a-Sketch channels (etch-a-sketch.h); ":us" = tm_time ticks
+DEFAULT_CHANNELS = ("0=left_pot,1=right_pot,2=left_avg,3=right_avg,"
+                    "4=loop:us,5=printf:us,6=wdt_jitter:us,7=wdt_count,8=accel_mag")
+TM_VERSION = 1
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xffff)."""
+    crc = 0xffff
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xffff
+    return crc
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise ValueError("bad COBS code")
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xff and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_channels(spec):
+    channels = {}
+    for item in spec.split(","):
+        cid, name = item.split("=")
+        us = name.endswith(":us")
+        channels[int(cid)] = (name[:-3] if us else name, us)
+    return channels
+
+
+def frames(read):
+    """Yield raw (COBS encoded) frames from a read(n) function."""
+    buf = bytearray()
+    while True:
+        chunk = read(256)
+        if not chunk:
+            if buf:
+                yield bytes(buf)
+            return
+        for b in chunk:
+            if b == 0:
+                if buf:
+                    yield bytes(buf)
+                buf = bytearray()
+            else:
+                buf.append(b)
+
+
+def open_input(name, baud):
+    if name == "-":
+        return sys.stdin.buffer.read
+    if os.path.isfile(name):
+        return open(name, "rb").read
+    try:
+        import serial
+    except ImportError:
+        sys.exit("pyserial is needed to read %s (pip install pyserial)" % name)
+    port = serial.Serial(name, baud, timeout=1)
+
+    def read(n):
+        while True:                     # a port never ends - wait for data
+            data = port.read(n)
+            if data:
+                return data
+    return read
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("input", help="serial port, capture file or - for stdin")
+    ap.add_argument("output", help="CSV file or - for stdout")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--channels", default=DEFAULT_CHANNELS,
+                    help="id=name[:us],... (default: Etch-a-Sketch)")
+    args = ap.parse_args()
+
+    channels = parse_channels(args.channels)
+    ids = sorted(channels)
+    out = sys.stdout if args.output == "-" else open(args.output, "w", newline="")
+    writer = csv.writer(out)
+    writer.writerow(["time_ms", "seq"] + [channels[i][0] for i in ids])
+
+    bad = missed = 0
+    last_seq = last_ms = None
+    elapsed = 0
+    try:
+        for raw in frames(open_input(args.input, args.baud)):
+            try:
+                frame = cobs_decode(raw)
+            except ValueError:
+                bad += 1
+                continue
+            if (len(frame) < 8 or frame[0] != TM_VERSION or (len(frame) - 8) % 3
+                    or crc16(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]):
+                bad += 1
+                continue
+            seq, ms, ticks_ms = struct.unpack("<BHH", frame[1:6])
+            if last_seq is not None:
+                missed += (seq - last_seq - 1) & 0xff
+                elapsed += (ms - last_ms) & 0xffff      # (wraps at 65.5s)
+            last_seq, last_ms = seq, ms
+            row = {}
+            for i in range(6, len(frame) - 2, 3):
+                cid, value = struct.unpack("<Bh", frame[i:i + 3])
+                name, us = channels.get(cid, ("ch%d" % cid, False))
+                row[cid] = round(value * 1000.0 / ticks_ms, 1) if us else value
+            writer.writerow([elapsed, seq] + [row.get(i, "") for i in ids])
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+    print("bad frames %d, missed frames %d" % (bad, missed), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()